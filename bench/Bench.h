@@ -0,0 +1,134 @@
+#ifndef LUCENE_UDR_BENCH_H
+#define LUCENE_UDR_BENCH_H
+
+/**
+ *  Micro-benchmark helpers for the Lucene UDR library.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace LuceneUDR::Bench
+{
+
+    struct BenchOptions
+    {
+        // size of the synthetic corpus in bytes
+        size_t corpusSize = 16 * 1024 * 1024;
+        // number of measured runs, the best one is reported
+        int iterations = 5;
+        // seed of the synthetic corpus generator
+        uint32_t seed = 42;
+        // run only benchmarks whose name contains this string
+        std::string filter;
+    };
+
+    /// <summary>
+    /// Deterministic pseudo-random generator, so that the corpora are the same on every run and platform.
+    /// </summary>
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed)
+            : m_state(seed ? seed : 1)
+        {}
+
+        uint32_t next()
+        {
+            // xorshift32
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+        uint32_t next(uint32_t bound)
+        {
+            return next() % bound;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    /// <summary>
+    /// Generates English-like text of the given size in bytes. 
+    /// The vocabulary mixes stop words, inflected forms and punctuation.
+    /// </summary>
+    std::string makeEnglishText(size_t size, uint32_t seed);
+
+    /// <summary>
+    /// Generates a list of documents of English-like text.
+    /// </summary>
+    std::vector<std::string> makeEnglishDocuments(size_t totalSize, size_t documentSize, uint32_t seed);
+
+    /// <summary>
+    /// Runs the benchmark body the given number of times and prints the throughput of the best run.
+    /// </summary>
+    /// 
+    /// <param name="options">Benchmark options</param>
+    /// <param name="name">Benchmark name</param>
+    /// <param name="bytes">Number of bytes processed by one run, 0 if not applicable</param>
+    /// <param name="items">Number of items processed by one run</param>
+    /// <param name="body">Benchmark body</param>
+    template <typename Body>
+    void runBenchmark(const BenchOptions& options, std::string_view name, size_t bytes, size_t items, Body&& body)
+    {
+        if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos) {
+            return;
+        }
+        // warm up
+        body();
+
+        double best = 0.0;
+        for (int i = 0; i < options.iterations; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            const auto finish = std::chrono::steady_clock::now();
+            const double seconds = std::chrono::duration<double>(finish - start).count();
+            if (i == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+
+        const std::string sName(name);
+        if (bytes > 0) {
+            std::printf("%-48s %10.3f ms %10.2f MB/s %14.0f items/s\n",
+                sName.c_str(), best * 1000.0, bytes / best / (1024.0 * 1024.0), items / best);
+        }
+        else {
+            std::printf("%-48s %10.3f ms %14.0f items/s\n",
+                sName.c_str(), best * 1000.0, items / best);
+        }
+    }
+
+    // Prevents the compiler from optimizing away the result of the benchmark body.
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+        static volatile const void* sink;
+        sink = &value;
+    }
+
+    void runEnglishAnalyzerBench(const BenchOptions& options);
+
+    void runIndexingBench(const BenchOptions& options);
+
+    void runSearchBench(const BenchOptions& options);
+}
+
+#endif // LUCENE_UDR_BENCH_H
@@ -0,0 +1,117 @@
+/**
+ *  Micro-benchmarks for the Lucene UDR library.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#include "Bench.h"
+#include "LuceneUdr.h"
+
+using namespace LuceneUDR::Bench;
+
+namespace {
+
+    constexpr const char* VOCABULARY[] = {
+        "the", "a", "an", "and", "or", "of", "to", "in", "is", "it", "that", "with", "for", "on", "are", "be",
+        "this", "was", "not", "but", "they", "by", "such", "there", "these", "will", "their", "into", "then",
+        "database", "databases", "index", "indexes", "indexing", "indexed", "search", "searching", "searched",
+        "query", "queries", "querying", "document", "documents", "relational", "relation", "relations",
+        "transaction", "transactions", "transactional", "analyzer", "analyzers", "analysis", "analyzing",
+        "connection", "connections", "connected", "connecting", "running", "runs", "runner", "generalization",
+        "generalizations", "happiness", "happily", "conditional", "conditionally", "rational", "rationalize",
+        "hopeful", "hopefully", "electricity", "electrical", "adjustment", "adjustable", "dependent",
+        "operator", "operators", "operational", "replication", "replicated", "firebird", "lucene", "fulltext",
+        "storage", "stored", "storing", "records", "recording", "recorded", "fields", "fielding", "keys"
+    };
+
+    constexpr const char* PUNCTUATION[] = { " ", " ", " ", " ", " ", ", ", ". ", "; ", " - ", "\n" };
+}
+
+namespace LuceneUDR::Bench
+{
+
+    std::string makeEnglishText(size_t size, uint32_t seed)
+    {
+        Random random(seed);
+        std::string text;
+        text.reserve(size + 32);
+        bool capitalize = true;
+        while (text.size() < size) {
+            std::string word = VOCABULARY[random.next(std::size(VOCABULARY))];
+            if (capitalize) {
+                word[0] = static_cast<char>(word[0] - 'a' + 'A');
+            }
+            text += word;
+            const char* delimiter = PUNCTUATION[random.next(std::size(PUNCTUATION))];
+            text += delimiter;
+            capitalize = (delimiter[0] == '.');
+        }
+        text.resize(size);
+        return text;
+    }
+
+    std::vector<std::string> makeEnglishDocuments(size_t totalSize, size_t documentSize, uint32_t seed)
+    {
+        std::vector<std::string> documents;
+        documents.reserve(totalSize / documentSize + 1);
+        for (size_t size = 0; size < totalSize; size += documentSize) {
+            documents.push_back(makeEnglishText(documentSize, seed + static_cast<uint32_t>(documents.size())));
+        }
+        return documents;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            options.corpusSize = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        }
+        else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            options.iterations = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else {
+            std::printf("Usage: %s [--size MB] [--iterations N] [--seed N] [--filter NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.iterations <= 0) {
+        options.iterations = 1;
+    }
+
+    std::printf("corpus size: %zu bytes, iterations: %d, seed: %u\n\n", 
+        options.corpusSize, options.iterations, options.seed);
+
+    try {
+        runEnglishAnalyzerBench(options);
+        runIndexingBench(options);
+        runSearchBench(options);
+    }
+    catch (const Firebird::FbException&) {
+        std::printf("error: Firebird exception\n");
+        return 1;
+    }
+    catch (const std::exception& e) {
+        std::printf("error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
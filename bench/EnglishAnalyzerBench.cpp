@@ -0,0 +1,164 @@
+/**
+ *  Benchmark of the EnglishAnalyzer filter chain.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "EnglishAnalyzer.h"
+#include "LowerCaseFilter.h"
+#include "PorterStemFilter.h"
+#include "PositionIncrementAttribute.h"
+#include "StandardFilter.h"
+#include "StandardTokenizer.h"
+#include "StopFilter.h"
+#include "StringReader.h"
+#include "StringUtils.h"
+#include "TermAttribute.h"
+
+using namespace Lucene;
+
+namespace {
+
+    class ChainedEnglishAnalyzerSavedStreams : public LuceneObject {
+    public:
+        StandardTokenizerPtr tokenStream;
+        TokenStreamPtr filteredTokenStream;
+    };
+
+    /// The filter chain used by EnglishAnalyzer before the fused filter was introduced.
+    /// Token streams are reused in the same way as by EnglishAnalyzer, so that only the filters are compared.
+    class ChainedEnglishAnalyzer : public Analyzer {
+    public:
+        explicit ChainedEnglishAnalyzer(LuceneVersion::Version matchVersion)
+            : matchVersion(matchVersion)
+            , stopSet(StopAnalyzer::ENGLISH_STOP_WORDS_SET())
+            , enableStopPositionIncrements(StopFilter::getEnablePositionIncrementsVersionDefault(matchVersion))
+            , replaceInvalidAcronym(LuceneVersion::onOrAfter(matchVersion, LuceneVersion::LUCENE_24))
+        {}
+
+        LUCENE_CLASS(ChainedEnglishAnalyzer);
+
+        TokenStreamPtr tokenStream(const String& fieldName, const ReaderPtr& reader) override
+        {
+            StandardTokenizerPtr tokenStream(newLucene<StandardTokenizer>(matchVersion, reader));
+            tokenStream->setMaxTokenLength(EnglishAnalyzer::DEFAULT_MAX_TOKEN_LENGTH);
+            TokenStreamPtr result(newLucene<StandardFilter>(tokenStream));
+            result = newLucene<LowerCaseFilter>(result);
+            result = newLucene<StopFilter>(enableStopPositionIncrements, result, stopSet);
+            result = newLucene<PorterStemFilter>(result);
+            return result;
+        }
+
+        TokenStreamPtr reusableTokenStream(const String& fieldName, const ReaderPtr& reader) override
+        {
+            auto streams = boost::dynamic_pointer_cast<ChainedEnglishAnalyzerSavedStreams>(getPreviousTokenStream());
+            if (!streams) {
+                streams = newLucene<ChainedEnglishAnalyzerSavedStreams>();
+                setPreviousTokenStream(streams);
+                streams->tokenStream = newLucene<StandardTokenizer>(matchVersion, reader);
+                streams->filteredTokenStream = newLucene<StandardFilter>(streams->tokenStream);
+                streams->filteredTokenStream = newLucene<LowerCaseFilter>(streams->filteredTokenStream);
+                streams->filteredTokenStream = newLucene<StopFilter>(enableStopPositionIncrements, streams->filteredTokenStream, stopSet);
+                streams->filteredTokenStream = newLucene<PorterStemFilter>(streams->filteredTokenStream);
+            }
+            else {
+                streams->tokenStream->reset(reader);
+            }
+            streams->tokenStream->setMaxTokenLength(EnglishAnalyzer::DEFAULT_MAX_TOKEN_LENGTH);
+
+            streams->tokenStream->setReplaceInvalidAcronym(replaceInvalidAcronym);
+
+            return streams->filteredTokenStream;
+        }
+
+    private:
+        LuceneVersion::Version matchVersion;
+        HashSet<String> stopSet;
+        bool enableStopPositionIncrements;
+        bool replaceInvalidAcronym;
+    };
+
+    struct AnalyzedToken
+    {
+        String term;
+        int32_t positionIncrement;
+
+        bool operator==(const AnalyzedToken& other) const
+        {
+            return positionIncrement == other.positionIncrement && term == other.term;
+        }
+    };
+
+    std::vector<AnalyzedToken> collectTokens(const AnalyzerPtr& analyzer, const String& text)
+    {
+        std::vector<AnalyzedToken> tokens;
+        TokenStreamPtr stream = analyzer->tokenStream(L"", newLucene<StringReader>(text));
+        TermAttributePtr termAttribute = stream->addAttribute<TermAttribute>();
+        PositionIncrementAttributePtr positionAttribute = stream->addAttribute<PositionIncrementAttribute>();
+        stream->reset();
+        while (stream->incrementToken()) {
+            tokens.push_back({ termAttribute->term(), positionAttribute->getPositionIncrement() });
+        }
+        stream->close();
+        return tokens;
+    }
+
+    size_t countTokens(const AnalyzerPtr& analyzer, const std::vector<String>& documents)
+    {
+        size_t count = 0;
+        for (const auto& document : documents) {
+            TokenStreamPtr stream = analyzer->reusableTokenStream(L"", newLucene<StringReader>(document));
+            stream->reset();
+            while (stream->incrementToken()) {
+                count++;
+            }
+            stream->end();
+        }
+        return count;
+    }
+}
+
+namespace LuceneUDR::Bench
+{
+
+    void runEnglishAnalyzerBench(const BenchOptions& options)
+    {
+        const auto utf8Documents = makeEnglishDocuments(options.corpusSize, 4096, options.seed);
+        std::vector<String> documents;
+        documents.reserve(utf8Documents.size());
+        for (const auto& document : utf8Documents) {
+            documents.push_back(StringUtils::toUnicode(document));
+        }
+
+        AnalyzerPtr chainedAnalyzer = newLucene<ChainedEnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        AnalyzerPtr englishAnalyzer = newLucene<EnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+
+        // both analyzers must produce the same terms at the same positions
+        for (const auto& document : documents) {
+            if (collectTokens(chainedAnalyzer, document) != collectTokens(englishAnalyzer, document)) {
+                throw std::runtime_error("EnglishAnalyzer output differs from the LowerCaseFilter/StopFilter/PorterStemFilter chain");
+            }
+        }
+
+        const size_t tokenCount = countTokens(englishAnalyzer, documents);
+
+        runBenchmark(options, "english_analyzer/chained_filters", options.corpusSize, tokenCount, [&]() {
+            doNotOptimize(countTokens(chainedAnalyzer, documents));
+        });
+        runBenchmark(options, "english_analyzer/fused_filter", options.corpusSize, tokenCount, [&]() {
+            doNotOptimize(countTokens(englishAnalyzer, documents));
+        });
+    }
+}
@@ -0,0 +1,289 @@
+#ifndef LUCENE_UDR_BENCH_FB_STUBS_H
+#define LUCENE_UDR_BENCH_FB_STUBS_H
+
+/**
+ *  Stub implementations of Firebird interfaces for benchmarks 
+ *  that run without a Firebird server.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LuceneUdr.h"
+
+namespace LuceneUDR::Bench
+{
+
+    struct StubColumn
+    {
+        std::string name;
+        unsigned type = SQL_VARYING;
+        unsigned length = 0;
+        unsigned charSet = CS_UTF8;
+        int subType = 0;
+
+        unsigned offset = 0;
+        unsigned nullOffset = 0;
+    };
+
+    /// <summary>
+    /// Message metadata with a fixed set of columns. 
+    /// Offsets are laid out the same way the Firebird metadata builder does it.
+    /// </summary>
+    class StubMessageMetadata final :
+        public Firebird::IMessageMetadataImpl<StubMessageMetadata, Firebird::ThrowStatusWrapper>
+    {
+    public:
+        explicit StubMessageMetadata(std::vector<StubColumn> columns)
+            : m_columns(std::move(columns))
+        {
+            unsigned offset = 0;
+            for (auto& column : m_columns) {
+                const unsigned alignment = getTypeAlignment(column.type);
+                offset = alignUp(offset, alignment);
+                column.offset = offset;
+                offset += getTypeSize(column);
+                offset = alignUp(offset, sizeof(short));
+                column.nullOffset = offset;
+                offset += sizeof(short);
+            }
+            m_messageLength = offset;
+        }
+
+        void addRef() {}
+
+        int release()
+        {
+            return 1;
+        }
+
+        unsigned getCount(Firebird::ThrowStatusWrapper*)
+        {
+            return static_cast<unsigned>(m_columns.size());
+        }
+
+        const char* getField(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].name.c_str();
+        }
+
+        const char* getRelation(Firebird::ThrowStatusWrapper*, unsigned)
+        {
+            return "BENCH";
+        }
+
+        const char* getOwner(Firebird::ThrowStatusWrapper*, unsigned)
+        {
+            return "SYSDBA";
+        }
+
+        const char* getAlias(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].name.c_str();
+        }
+
+        unsigned getType(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].type;
+        }
+
+        FB_BOOLEAN isNullable(Firebird::ThrowStatusWrapper*, unsigned)
+        {
+            return FB_TRUE;
+        }
+
+        int getSubType(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].subType;
+        }
+
+        unsigned getLength(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].length;
+        }
+
+        int getScale(Firebird::ThrowStatusWrapper*, unsigned)
+        {
+            return 0;
+        }
+
+        unsigned getCharSet(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].charSet;
+        }
+
+        unsigned getOffset(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].offset;
+        }
+
+        unsigned getNullOffset(Firebird::ThrowStatusWrapper*, unsigned index)
+        {
+            return m_columns[index].nullOffset;
+        }
+
+        Firebird::IMetadataBuilder* getBuilder(Firebird::ThrowStatusWrapper*)
+        {
+            return nullptr;
+        }
+
+        unsigned getMessageLength(Firebird::ThrowStatusWrapper*)
+        {
+            return m_messageLength;
+        }
+
+#if FB_API_VER >= 40
+        unsigned getAlignment(Firebird::ThrowStatusWrapper*)
+        {
+            return sizeof(ISC_INT64);
+        }
+
+        unsigned getAlignedLength(Firebird::ThrowStatusWrapper*)
+        {
+            return alignUp(m_messageLength, sizeof(ISC_INT64));
+        }
+#endif
+
+        const std::vector<StubColumn>& columns() const
+        {
+            return m_columns;
+        }
+
+        /// <summary>
+        /// Writes a value of the VARCHAR or CHAR column into the message buffer.
+        /// </summary>
+        void setString(unsigned char* buffer, unsigned index, std::string_view value) const
+        {
+            const auto& column = m_columns[index];
+            const auto length = static_cast<unsigned short>(std::min<size_t>(value.size(), column.length));
+            *reinterpret_cast<short*>(buffer + column.nullOffset) = 0;
+            if (column.type == SQL_VARYING) {
+                *reinterpret_cast<unsigned short*>(buffer + column.offset) = length;
+                std::memcpy(buffer + column.offset + sizeof(short), value.data(), length);
+            }
+            else {
+                std::memset(buffer + column.offset, ' ', column.length);
+                std::memcpy(buffer + column.offset, value.data(), length);
+            }
+        }
+
+        void setNull(unsigned char* buffer, unsigned index) const
+        {
+            *reinterpret_cast<short*>(buffer + m_columns[index].nullOffset) = -1;
+        }
+
+    private:
+        static unsigned alignUp(unsigned value, unsigned alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        static unsigned getTypeAlignment(unsigned type)
+        {
+            switch (type) {
+            case SQL_VARYING:
+            case SQL_SHORT:
+                return sizeof(short);
+            case SQL_LONG:
+                return sizeof(ISC_LONG);
+            case SQL_TEXT:
+                return 1;
+            default:
+                return sizeof(ISC_INT64);
+            }
+        }
+
+        static unsigned getTypeSize(const StubColumn& column)
+        {
+            switch (column.type) {
+            case SQL_VARYING:
+                return column.length + sizeof(short);
+            case SQL_BLOB:
+                return sizeof(ISC_QUAD);
+            default:
+                return column.length;
+            }
+        }
+
+    private:
+        std::vector<StubColumn> m_columns;
+        unsigned m_messageLength = 0;
+    };
+
+    /// <summary>
+    /// BLOB that returns the given text in segments of the given size.
+    /// </summary>
+    class StubBlob final :
+        public Firebird::IBlobImpl<StubBlob, Firebird::ThrowStatusWrapper>
+    {
+    public:
+        StubBlob(std::string_view data, unsigned segmentSize)
+            : m_data(data)
+            , m_segmentSize(segmentSize)
+        {}
+
+        void rewind()
+        {
+            m_position = 0;
+        }
+
+        void addRef() {}
+
+        int release()
+        {
+            return 1;
+        }
+
+        void getInfo(Firebird::ThrowStatusWrapper*, unsigned, const unsigned char*, unsigned, unsigned char*) {}
+
+        int getSegment(Firebird::ThrowStatusWrapper*, unsigned bufferLength, void* buffer, unsigned* segmentLength)
+        {
+            if (m_position >= m_data.size()) {
+                *segmentLength = 0;
+                return Firebird::IStatus::RESULT_NO_DATA;
+            }
+            const size_t length = std::min<size_t>({ bufferLength, m_segmentSize, m_data.size() - m_position });
+            std::memcpy(buffer, m_data.data() + m_position, length);
+            m_position += length;
+            *segmentLength = static_cast<unsigned>(length);
+            return Firebird::IStatus::RESULT_OK;
+        }
+
+        void putSegment(Firebird::ThrowStatusWrapper*, unsigned, const void*) {}
+
+        void cancel(Firebird::ThrowStatusWrapper*) {}
+
+        void close(Firebird::ThrowStatusWrapper*) {}
+
+#if FB_API_VER >= 40
+        void deprecatedCancel(Firebird::ThrowStatusWrapper*) {}
+
+        void deprecatedClose(Firebird::ThrowStatusWrapper*) {}
+#endif
+
+        int seek(Firebird::ThrowStatusWrapper*, int, int)
+        {
+            return 0;
+        }
+
+    private:
+        std::string_view m_data;
+        size_t m_position = 0;
+        unsigned m_segmentSize;
+    };
+
+}
+
+#endif // LUCENE_UDR_BENCH_FB_STUBS_H
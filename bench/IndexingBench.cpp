@@ -0,0 +1,118 @@
+/**
+ *  Benchmarks of the indexing hot path: hex conversion of keys, 
+ *  reading BLOBs and building Lucene documents from output messages.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "FbStubs.h"
+#include "FBFieldInfo.h"
+#include "FBUtils.h"
+#include "FTSHelper.h"
+
+using namespace Firebird;
+using namespace Lucene;
+using namespace LuceneUDR;
+
+namespace LuceneUDR::Bench
+{
+
+    void runIndexingBench(const BenchOptions& options)
+    {
+        // The stubs never report errors, so the status wrapper does not need a real status object.
+        ThrowStatusWrapper status(nullptr);
+        Random random(options.seed);
+
+        // hex conversion of DB_KEY and UUID values
+        {
+            constexpr size_t KEY_COUNT = 1 << 18;
+            std::vector<std::vector<unsigned char>> keys(KEY_COUNT, std::vector<unsigned char>(16));
+            for (auto& key : keys) {
+                for (auto& b : key) {
+                    b = static_cast<unsigned char>(random.next());
+                }
+            }
+            std::vector<std::string> hexKeys;
+            hexKeys.reserve(KEY_COUNT);
+            for (const auto& key : keys) {
+                hexKeys.push_back(binary_to_hex(key.data(), key.size()));
+            }
+
+            runBenchmark(options, "hex/binary_to_hex_uuid", KEY_COUNT * 16, KEY_COUNT, [&]() {
+                for (const auto& key : keys) {
+                    doNotOptimize(binary_to_hex(key.data(), key.size()));
+                }
+            });
+            runBenchmark(options, "hex/hex_to_binary_uuid", KEY_COUNT * 32, KEY_COUNT, [&]() {
+                for (const auto& hexKey : hexKeys) {
+                    doNotOptimize(hex_to_binary(hexKey));
+                }
+            });
+        }
+
+        // reading text BLOBs
+        {
+            const auto documents = makeEnglishDocuments(options.corpusSize, 256 * 1024, options.seed);
+            for (unsigned segmentSize : { 4096u, 65535u }) {
+                std::vector<StubBlob> blobs;
+                blobs.reserve(documents.size());
+                for (const auto& document : documents) {
+                    blobs.emplace_back(document, segmentSize);
+                }
+                const std::string name = "blob/read_string_segment_" + std::to_string(segmentSize);
+                runBenchmark(options, name, options.corpusSize, documents.size(), [&]() {
+                    for (auto& blob : blobs) {
+                        blob.rewind();
+                        doNotOptimize(readStringFromBlob(&status, &blob));
+                    }
+                });
+            }
+        }
+
+        // building documents from output messages
+        {
+            StubMessageMetadata meta({
+                { "ID", SQL_VARYING, 20 * 4 },
+                { "TITLE", SQL_VARYING, 250 * 4 },
+                { "BODY", SQL_VARYING, 8000 }
+            });
+            auto fields = FTSMetadata::makeFbFieldsInfo(&status, &meta);
+            for (auto& field : fields) {
+                field.ftsFieldName = StringUtils::toUnicode(field.fieldName);
+                field.ftsKey = (field.fieldName == "ID");
+            }
+
+            const size_t recordCount = std::max<size_t>(options.corpusSize / 4096, 1);
+            const size_t messageLength = meta.getMessageLength(&status);
+            std::vector<unsigned char> messages(recordCount * messageLength);
+            size_t bytes = 0;
+            for (size_t i = 0; i < recordCount; i++) {
+                unsigned char* buffer = messages.data() + i * messageLength;
+                const std::string title = makeEnglishText(80, options.seed + static_cast<uint32_t>(i));
+                const std::string body = makeEnglishText(4000, options.seed + static_cast<uint32_t>(i) + 1);
+                meta.setString(buffer, 0, std::to_string(i + 1));
+                meta.setString(buffer, 1, title);
+                meta.setString(buffer, 2, body);
+                bytes += title.size() + body.size();
+            }
+
+            runBenchmark(options, "document/make_fts_document", bytes, recordCount, [&]() {
+                for (size_t i = 0; i < recordCount; i++) {
+                    doNotOptimize(makeFtsDocument(&status, nullptr, nullptr, fields, messages.data() + i * messageLength));
+                }
+            });
+        }
+    }
+}
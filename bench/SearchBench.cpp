@@ -0,0 +1,231 @@
+/**
+ *  Benchmarks of the search hot path: analyzer construction, 
+ *  query escaping, the FTS$SEARCH fetch loop and the directory implementations.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "FbStubs.h"
+#include "FBFieldInfo.h"
+#include "FTSHelper.h"
+#include "FTSUtils.h"
+#include "LuceneAnalyzerFactory.h"
+#include "MMapDirectory.h"
+
+using namespace Firebird;
+using namespace Lucene;
+using namespace LuceneUDR;
+
+namespace fs = std::filesystem;
+
+namespace LuceneUDR::Bench
+{
+    namespace
+    {
+        StubMessageMetadata makeRecordMetadata()
+        {
+            return StubMessageMetadata({
+                { "ID", SQL_VARYING, 20 * 4 },
+                { "TITLE", SQL_VARYING, 250 * 4 },
+                { "BODY", SQL_VARYING, 8000 }
+            });
+        }
+
+        // Writes an optimized index of synthetic records to the directory.
+        void buildIndex(ThrowStatusWrapper* status, StubMessageMetadata& meta, const FTSMetadata::FbFieldsInfo& fields,
+            const DirectoryPtr& directory, const AnalyzerPtr& analyzer, size_t recordCount, uint32_t seed)
+        {
+            auto indexWriter = newLucene<IndexWriter>(directory, analyzer, true, IndexWriter::MaxFieldLengthUNLIMITED);
+            std::vector<unsigned char> buffer(meta.getMessageLength(status));
+            for (size_t i = 0; i < recordCount; i++) {
+                meta.setString(buffer.data(), 0, std::to_string(i + 1));
+                meta.setString(buffer.data(), 1, makeEnglishText(80, seed + static_cast<uint32_t>(i)));
+                meta.setString(buffer.data(), 2, makeEnglishText(4000, seed + static_cast<uint32_t>(i) + 1));
+                auto doc = makeFtsDocument(status, nullptr, nullptr, fields, buffer.data());
+                if (doc) {
+                    indexWriter->addDocument(doc);
+                }
+            }
+            indexWriter->optimize();
+            indexWriter->close();
+        }
+    }
+
+    void runSearchBench(const BenchOptions& options)
+    {
+        // The stubs never report errors, so the status wrapper does not need a real status object.
+        ThrowStatusWrapper status(nullptr);
+        LuceneAnalyzerFactory analyzerFactory;
+
+        // analyzer construction
+        {
+            const auto analyzerNames = analyzerFactory.getAnalyzerNames();
+            constexpr size_t ROUNDS = 100;
+            runBenchmark(options, "analyzer/create_all_system", 0, ROUNDS * analyzerNames.size(), [&]() {
+                for (size_t i = 0; i < ROUNDS; i++) {
+                    for (const auto& analyzerName : analyzerNames) {
+                        doNotOptimize(analyzerFactory.createAnalyzer(&status, analyzerName));
+                    }
+                }
+            });
+            runBenchmark(options, "analyzer/get_all_system_pooled", 0, ROUNDS * analyzerNames.size(), [&]() {
+                for (size_t i = 0; i < ROUNDS; i++) {
+                    for (const auto& analyzerName : analyzerNames) {
+                        doNotOptimize(analyzerFactory.getAnalyzer(&status, analyzerName));
+                    }
+                }
+            });
+        }
+
+        // query escaping
+        {
+            constexpr size_t QUERY_COUNT = 1 << 16;
+            Random random(options.seed);
+            std::vector<std::string> queries;
+            queries.reserve(QUERY_COUNT);
+            size_t bytes = 0;
+            for (size_t i = 0; i < QUERY_COUNT; i++) {
+                std::string query = makeEnglishText(64, options.seed + static_cast<uint32_t>(i));
+                // sprinkle special characters of the query syntax
+                for (int j = 0; j < 4; j++) {
+                    query[random.next(static_cast<uint32_t>(query.size()))] = "+-!^\"~*?:\\&|()[]{}"[random.next(18)];
+                }
+                bytes += query.size();
+                queries.push_back(std::move(query));
+            }
+            runBenchmark(options, "query/escape", bytes, QUERY_COUNT, [&]() {
+                for (const auto& query : queries) {
+                    doNotOptimize(queryEscape(query));
+                }
+            });
+        }
+
+        // FTS$SEARCH fetch loop over an in-memory index
+        {
+            auto meta = makeRecordMetadata();
+            auto fields = FTSMetadata::makeFbFieldsInfo(&status, &meta);
+            for (auto& field : fields) {
+                field.ftsFieldName = StringUtils::toUnicode(field.fieldName);
+                field.ftsKey = (field.fieldName == "ID");
+            }
+            const String unicodeKeyFieldName = L"ID";
+
+            auto analyzer = analyzerFactory.getAnalyzer(&status, "ENGLISH");
+            auto directory = newLucene<RAMDirectory>();
+            const size_t recordCount = std::max<size_t>(options.corpusSize / 4096, 1);
+            buildIndex(&status, meta, fields, directory, analyzer, recordCount, options.seed);
+
+            auto searcher = newLucene<IndexSearcher>(directory, true);
+            auto searchFields = newCollection<String>(L"TITLE", L"BODY");
+            auto parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, searchFields, analyzer);
+            parser->setDefaultOperator(QueryParser::OR_OPERATOR);
+            auto query = parser->parse(L"database transactions");
+            constexpr int32_t LIMIT = 1000;
+
+            const auto docs = searcher->search(query, LIMIT);
+            runBenchmark(options, "search/fetch_loop_int_key", 0, docs->scoreDocs.size(), [&]() {
+                // the same work FTS$SEARCH does for every fetched record
+                for (const auto& scoreDoc : docs->scoreDocs) {
+                    DocumentPtr doc = searcher->doc(scoreDoc->doc);
+                    const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
+                    doNotOptimize(std::stoll(keyValue));
+                    doNotOptimize(scoreDoc->score);
+                }
+            });
+            runBenchmark(options, "search/search_and_fetch", 0, docs->scoreDocs.size(), [&]() {
+                const auto topDocs = searcher->search(query, LIMIT);
+                for (const auto& scoreDoc : topDocs->scoreDocs) {
+                    DocumentPtr doc = searcher->doc(scoreDoc->doc);
+                    const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
+                    doNotOptimize(std::stoll(keyValue));
+                }
+            });
+            searcher->close();
+        }
+
+        // FTS$SEARCH over an index persisted on disk, read with buffered I/O (directoryType=fs) 
+        // and with memory mapped files (directoryType=mmap)
+        {
+            auto meta = makeRecordMetadata();
+            auto fields = FTSMetadata::makeFbFieldsInfo(&status, &meta);
+            for (auto& field : fields) {
+                field.ftsFieldName = StringUtils::toUnicode(field.fieldName);
+                field.ftsKey = (field.fieldName == "ID");
+            }
+            const String unicodeKeyFieldName = L"ID";
+
+            const fs::path indexDirectoryPath = fs::temp_directory_path() / "luceneudr_bench_directory";
+            fs::remove_all(indexDirectoryPath);
+            fs::create_directories(indexDirectoryPath);
+
+            auto analyzer = analyzerFactory.getAnalyzer(&status, "ENGLISH");
+            const size_t recordCount = std::max<size_t>(options.corpusSize / 4096, 1);
+            buildIndex(&status, meta, fields, FSDirectory::open(indexDirectoryPath.wstring()), analyzer, recordCount, options.seed);
+
+            // the same queries for both directories: single terms, disjunctions, phrases and prefixes
+            auto searchFields = newCollection<String>(L"TITLE", L"BODY");
+            auto parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, searchFields, analyzer);
+            parser->setDefaultOperator(QueryParser::OR_OPERATOR);
+            const std::vector<String> queryTexts = {
+                L"database", L"lucene", L"replication", L"firebird AND storage",
+                L"database transactions", L"indexing OR searching OR querying", L"\"relational database\"",
+                L"analy*", L"connect*", L"+hopeful -electricity", L"\"stored records\"~3", L"operator operational"
+            };
+            std::vector<QueryPtr> queries;
+            queries.reserve(queryTexts.size());
+            for (const auto& queryText : queryTexts) {
+                queries.push_back(parser->parse(queryText));
+            }
+            constexpr int32_t LIMIT = 100;
+
+            const auto searchAndFetch = [&](const IndexSearcherPtr& searcher, const QueryPtr& query) {
+                const auto topDocs = searcher->search(query, LIMIT);
+                for (const auto& scoreDoc : topDocs->scoreDocs) {
+                    DocumentPtr doc = searcher->doc(scoreDoc->doc);
+                    const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
+                    doNotOptimize(std::stoll(keyValue));
+                }
+            };
+
+            const std::pair<std::string, std::function<DirectoryPtr()>> directoryTypes[] = {
+                { "fs", [&]() -> DirectoryPtr { return FSDirectory::open(indexDirectoryPath.wstring()); } },
+                { "mmap", [&]() -> DirectoryPtr { return newLucene<MMapDirectory>(indexDirectoryPath.wstring()); } }
+            };
+            for (const auto& [typeName, openDirectory] : directoryTypes) {
+                // a searcher kept open, as by a resident reader
+                auto searcher = newLucene<IndexSearcher>(openDirectory(), true);
+                runBenchmark(options, "directory/" + typeName + "/search_and_fetch", 0, queries.size(), [&]() {
+                    for (const auto& query : queries) {
+                        searchAndFetch(searcher, query);
+                    }
+                });
+                searcher->close();
+
+                // every FTS$SEARCH call opens the index anew
+                runBenchmark(options, "directory/" + typeName + "/open_search_and_fetch", 0, queries.size(), [&]() {
+                    for (const auto& query : queries) {
+                        auto querySearcher = newLucene<IndexSearcher>(openDirectory(), true);
+                        searchAndFetch(querySearcher, query);
+                        querySearcher->close();
+                    }
+                });
+            }
+
+            fs::remove_all(indexDirectoryPath);
+        }
+    }
+}
@@ -34,6 +34,11 @@ CREATE TABLE FTS$INDICES(
    FTS$ANALYZER     VARCHAR(63) CHARACTER SET UTF8 DEFAULT 'STANDARD' NOT NULL,
    FTS$DESCRIPTION  BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
    FTS$INDEX_STATUS FTS$D_INDEX_STATUS DEFAULT 'N' NOT NULL,
+   FTS$ALL_FIELD    BOOLEAN DEFAULT FALSE,
+   FTS$SHARD_COUNT  SMALLINT DEFAULT 1,
+   FTS$PARTITION_FIELD VARCHAR(63) CHARACTER SET UTF8,
+   FTS$PARTITION_TYPE VARCHAR(10) CHARACTER SET UTF8,
+   FTS$REBUILD_CHUNK_SIZE INTEGER,
    CONSTRAINT PK_FTS$INDEX_NAME PRIMARY KEY(FTS$INDEX_NAME)
 );
 
@@ -61,11 +66,32 @@ COMMENT ON COLUMN FTS$INDICES.FTS$DESCRIPTION IS
 COMMENT ON COLUMN FTS$INDICES.FTS$INDEX_STATUS IS
 'Full-text index status.';
 
+COMMENT ON COLUMN FTS$INDICES.FTS$ALL_FIELD IS
+'Are all content fields also indexed together in the catch-all field _ALL';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$SHARD_COUNT IS
+'Number of shards the documents of the index are distributed over';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARTITION_FIELD IS
+'Field whose values split the documents of the index into partitions';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARTITION_TYPE IS
+'Partitioning type: VALUE - a partition per value of the field, MONTH - a partition per month of the date field';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$REBUILD_CHUNK_SIZE IS
+'Chunk size of a chunked rebuild in progress. Until it completes, changes of the table are kept in FTS$LOG';
+
 CREATE TABLE FTS$INDEX_SEGMENTS(
    FTS$INDEX_NAME    VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
    FTS$FIELD_NAME    VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
    FTS$BOOST         DOUBLE PRECISION,
    FTS$KEY           BOOLEAN DEFAULT FALSE NOT NULL,
+   FTS$SORTABLE      BOOLEAN DEFAULT FALSE,
+   FTS$REVERSED      BOOLEAN DEFAULT FALSE,
+   FTS$OMIT_NORMS    BOOLEAN DEFAULT FALSE,
+   FTS$OMIT_POSITIONS BOOLEAN DEFAULT FALSE,
+   FTS$TERM_VECTORS  BOOLEAN DEFAULT FALSE,
+   FTS$NOT_ANALYZED  BOOLEAN DEFAULT FALSE,
    CONSTRAINT UK_FTS$INDEX_SEGMENTS UNIQUE(FTS$INDEX_NAME, FTS$FIELD_NAME),
    CONSTRAINT FK_FTS$INDEX_SEGMENTS FOREIGN KEY(FTS$INDEX_NAME) REFERENCES FTS$INDICES(FTS$INDEX_NAME) ON DELETE CASCADE
 );
@@ -86,10 +112,30 @@ COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$BOOST IS
 COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$KEY IS 
 'Is the field a key';
 
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$SORTABLE IS 
+'Can search results be sorted by the field';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$REVERSED IS 
+'Are the reversed terms of the field indexed for leading wildcard queries';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$OMIT_NORMS IS 
+'Are length normalization factors and index-time boosts of the field omitted';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$OMIT_POSITIONS IS 
+'Are term frequencies and positions of the field omitted';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$TERM_VECTORS IS 
+'Are term vectors with positions and offsets of the field stored';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$NOT_ANALYZED IS 
+'Is the whole value of the field indexed as a single term';
+
 CREATE TABLE FTS$ANALYZERS (
     FTS$ANALYZER_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$BASE_ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$DESCRIPTION   BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$MIN_GRAM      SMALLINT,
+    FTS$MAX_GRAM      SMALLINT,
     CONSTRAINT PK_FTS$ANALYZER PRIMARY KEY(FTS$ANALYZER_NAME)
 );
 
@@ -105,6 +151,12 @@ COMMENT ON COLUMN FTS$ANALYZERS.FTS$ANALYZER_NAME IS
 COMMENT ON COLUMN FTS$ANALYZERS.FTS$ANALYZER_NAME IS 
 'Description of analyzer';
 
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$MIN_GRAM IS 
+'Minimum n-gram length for analyzers based on NGRAM and EDGE_NGRAM';
+
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$MAX_GRAM IS 
+'Maximum n-gram length for analyzers based on NGRAM and EDGE_NGRAM';
+
 CREATE TABLE FTS$STOP_WORDS (
     FTS$ANALYZER_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$WORD VARCHAR(63) CHARACTER SET UTF8 NOT NULL COLLATE UNICODE_CI,
@@ -247,12 +299,16 @@ BEGIN
    * Input parameters:
    *   FTS$ANALYZER - analyzer name;
    *   FTS$BASE_ANALYZER - name of base analyzer;
-   *   FTS$DESCRIPTION - description of the analyzer.
+   *   FTS$DESCRIPTION - description of the analyzer;
+   *   FTS$MIN_GRAM - minimum n-gram length, only for the base analyzers NGRAM and EDGE_NGRAM;
+   *   FTS$MAX_GRAM - maximum n-gram length, only for the base analyzers NGRAM and EDGE_NGRAM.
   **/
   PROCEDURE FTS$CREATE_ANALYZER (
       FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
       FTS$BASE_ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
-      FTS$DESCRIPTION BLOB SUB_TYPE TEXT CHARACTER SET UTF8 DEFAULT NULL
+      FTS$DESCRIPTION BLOB SUB_TYPE TEXT CHARACTER SET UTF8 DEFAULT NULL,
+      FTS$MIN_GRAM SMALLINT DEFAULT NULL,
+      FTS$MAX_GRAM SMALLINT DEFAULT NULL
   );
 
   /**
@@ -396,13 +452,129 @@ BEGIN
       FTS$BOOST DOUBLE PRECISION
   );
 
+  /**
+   * Allows or forbids sorting the search results by the full-text index field.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$FIELD_NAME - name of the field;
+   *   FTS$SORTABLE - whether the field can be used in FTS$SEARCH.FTS$SORT.
+  **/
+  PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$SORTABLE BOOLEAN NOT NULL
+  );
+
+  /**
+   * Enables or disables indexing the reversed terms of the full-text index field,
+   * which makes search queries with a leading wildcard (*ing) fast.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$FIELD_NAME - name of the field;
+   *   FTS$REVERSED - whether the reversed terms of the field are indexed.
+  **/
+  PROCEDURE FTS$SET_INDEX_FIELD_REVERSED (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$REVERSED BOOLEAN NOT NULL
+  );
+
+  /**
+   * Sets how the full-text index field is indexed.
+   * NULL options keep their current values.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$FIELD_NAME - name of the field;
+   *   FTS$OMIT_NORMS - do not store length normalization factors and index-time boosts;
+   *   FTS$OMIT_POSITIONS - do not store term frequencies and positions;
+   *   FTS$TERM_VECTORS - store term vectors with positions and offsets;
+   *   FTS$NOT_ANALYZED - index the whole value of the field as a single term.
+  **/
+  PROCEDURE FTS$SET_INDEX_FIELD_OPTIONS (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$OMIT_NORMS BOOLEAN DEFAULT NULL,
+      FTS$OMIT_POSITIONS BOOLEAN DEFAULT NULL,
+      FTS$TERM_VECTORS BOOLEAN DEFAULT NULL,
+      FTS$NOT_ANALYZED BOOLEAN DEFAULT NULL
+  );
+
+  /**
+   * Enables or disables the catch-all field _ALL of the full-text index.
+   * It holds the terms of all content fields, and search terms
+   * without an explicit field name are searched in it only.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$ALL_FIELD - whether the index has the catch-all field.
+  **/
+  PROCEDURE FTS$SET_INDEX_ALL_FIELD (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$ALL_FIELD BOOLEAN NOT NULL
+  );
+
+  /**
+   * Sets the number of shards of the full-text index.
+   * Documents are distributed over the shards by the hash of their key,
+   * and the shards are searched in parallel.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$SHARD_COUNT - number of shards, from 1 to 64.
+  **/
+  PROCEDURE FTS$SET_INDEX_SHARD_COUNT (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$SHARD_COUNT SMALLINT NOT NULL
+  );
+
+  /**
+   * Sets the partition field of the full-text index.
+   * Documents with different values of the field are written to separate
+   * partitions, and FTS$SEARCH with FTS$PARTITION searches only one of them.
+   * The index must be rebuilt after the change.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$FIELD_NAME - name of an index field, NULL removes the partitioning;
+   *   FTS$PARTITION_TYPE - VALUE - a partition per value of the field,
+   *     MONTH - a partition per month of a DATE or TIMESTAMP field.
+  **/
+  PROCEDURE FTS$SET_INDEX_PARTITION (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+      FTS$PARTITION_TYPE VARCHAR(10) CHARACTER SET UTF8 NOT NULL DEFAULT 'VALUE'
+  );
+
   /**
    * Rebuild the full-text index.
    *
    * Input parameters:
-   *   FTS$INDEX_NAME - index name.
+   *   FTS$INDEX_NAME - index name;
+   *   FTS$CHUNK_SIZE - if specified, the table is read in chunks of this number of records 
+   *                    in the order of the key, each in its own short read-only transaction. 
+   *                    Changes of the table are kept in FTS$LOG until the rebuild completes.
    **/
   PROCEDURE FTS$REBUILD_INDEX (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$CHUNK_SIZE INTEGER DEFAULT NULL
+  );
+
+  /**
+   * Resume an interrupted chunked rebuild of the full-text index 
+   * after the last chunk committed to the index.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - index name.
+   **/
+  PROCEDURE FTS$RESUME_REBUILD (
       FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
   );
 
@@ -528,7 +700,9 @@ BEGIN
   PROCEDURE FTS$CREATE_ANALYZER (
     FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$BASE_ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
-    FTS$DESCRIPTION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+    FTS$DESCRIPTION BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$MIN_GRAM SMALLINT,
+    FTS$MAX_GRAM SMALLINT
   )
   AS
   BEGIN
@@ -538,14 +712,25 @@ BEGIN
     IF (NOT FTS$HAS_SYSTEM_ANALYZER(FTS$BASE_ANALYZER)) THEN
       EXCEPTION FTS$EXCEPTION 'Cannot create analyzer. Base analyzer "' || FTS$BASE_ANALYZER || '" not exists or not system analyzer.';
 
+    IF ((FTS$MIN_GRAM IS NOT NULL OR FTS$MAX_GRAM IS NOT NULL) AND
+        UPPER(FTS$BASE_ANALYZER) NOT IN ('NGRAM', 'EDGE_NGRAM')) THEN
+      EXCEPTION FTS$EXCEPTION 'Cannot create analyzer. N-gram lengths can only be set for the base analyzers NGRAM and EDGE_NGRAM.';
+
+    IF (FTS$MIN_GRAM < 1 OR FTS$MAX_GRAM > 255 OR FTS$MAX_GRAM < FTS$MIN_GRAM) THEN
+      EXCEPTION FTS$EXCEPTION 'Cannot create analyzer. Invalid n-gram lengths.';
+
     INSERT INTO FTS$ANALYZERS (
       FTS$ANALYZER_NAME,
       FTS$BASE_ANALYZER,
-      FTS$DESCRIPTION)
+      FTS$DESCRIPTION,
+      FTS$MIN_GRAM,
+      FTS$MAX_GRAM)
     VALUES (
       :FTS$ANALYZER,
       :FTS$BASE_ANALYZER,
-      :FTS$DESCRIPTION
+      :FTS$DESCRIPTION,
+      :FTS$MIN_GRAM,
+      :FTS$MAX_GRAM
     );
   END
 
@@ -719,12 +904,68 @@ BEGIN
   EXTERNAL NAME 'luceneudr!setIndexFieldBoost' ENGINE UDR;
 
 
+  PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$SORTABLE BOOLEAN NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexFieldSortable' ENGINE UDR;
+
+
+  PROCEDURE FTS$SET_INDEX_FIELD_REVERSED (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$REVERSED BOOLEAN NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexFieldReversed' ENGINE UDR;
+
+
+  PROCEDURE FTS$SET_INDEX_FIELD_OPTIONS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$OMIT_NORMS BOOLEAN,
+    FTS$OMIT_POSITIONS BOOLEAN,
+    FTS$TERM_VECTORS BOOLEAN,
+    FTS$NOT_ANALYZED BOOLEAN
+  )
+  EXTERNAL NAME 'luceneudr!setIndexFieldOptions' ENGINE UDR;
+
+
+  PROCEDURE FTS$SET_INDEX_ALL_FIELD (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$ALL_FIELD BOOLEAN NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexAllField' ENGINE UDR;
+
+
+  PROCEDURE FTS$SET_INDEX_SHARD_COUNT (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$SHARD_COUNT SMALLINT NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexShardCount' ENGINE UDR;
+
+
+  PROCEDURE FTS$SET_INDEX_PARTITION (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$PARTITION_TYPE VARCHAR(10) CHARACTER SET UTF8 NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexPartition' ENGINE UDR;
+
+
   PROCEDURE FTS$REBUILD_INDEX (
-    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$CHUNK_SIZE INTEGER
   )
   EXTERNAL NAME 'luceneudr!rebuildIndex' ENGINE UDR;
 
 
+  PROCEDURE FTS$RESUME_REBUILD (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!resumeRebuild' ENGINE UDR;
+
+
   PROCEDURE FTS$REINDEX_TABLE (
     FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
   )
@@ -797,7 +1038,10 @@ CREATE OR ALTER PROCEDURE FTS$SEARCH (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
     FTS$LIMIT INT NOT NULL DEFAULT 1000,
-    FTS$EXPLAIN BOOLEAN DEFAULT FALSE
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$SORT VARCHAR(1024) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$TIMEOUT INT DEFAULT NULL,
+    FTS$PARTITION VARCHAR(255) CHARACTER SET UTF8 DEFAULT NULL
 )
 RETURNS (
     FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
@@ -806,7 +1050,9 @@ RETURNS (
     FTS$ID INTEGER,
     FTS$UUID CHAR(16) CHARACTER SET OCTETS,
     FTS$SCORE DOUBLE PRECISION,
-    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$TOTAL_HITS INTEGER,
+    FTS$TIMED_OUT BOOLEAN
 )
 EXTERNAL NAME 'luceneudr!ftsSearch'
 ENGINE UDR;
@@ -826,6 +1072,9 @@ COMMENT ON PARAMETER FTS$SEARCH.FTS$LIMIT IS
 COMMENT ON PARAMETER FTS$SEARCH.FTS$EXPLAIN IS
 'Explain the search results';
 
+COMMENT ON PARAMETER FTS$SEARCH.FTS$SORT IS
+'Sort order of the search results: comma separated list of sortable fields and FTS$SCORE with optional ASC or DESC';
+
 COMMENT ON PARAMETER FTS$SEARCH.FTS$RELATION_NAME IS
 'The name of the table in which the document is found.';
 
@@ -838,9 +1087,196 @@ COMMENT ON PARAMETER FTS$SEARCH.FTS$SCORE IS
 COMMENT ON PARAMETER FTS$SEARCH.FTS$EXPLANATION IS
 'Explanation of the search result';
 
+COMMENT ON PARAMETER FTS$SEARCH.FTS$TOTAL_HITS IS
+'Total number of documents matching the query, regardless of the limit';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$TIMEOUT IS
+'Time allowed for the search in milliseconds, 0 - no limit. By default, the searchTimeout option is used';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$PARTITION IS
+'Value of the partition field, only this partition of a partitioned index is searched';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$TIMED_OUT IS
+'The search was interrupted by timeout, only the documents found before it are returned';
+
 GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH;
 GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH;
 
+CREATE OR ALTER PROCEDURE FTS$SEARCH_MULTI (
+    FTS$INDEX_NAMES VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 1000
+)
+RETURNS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID INTEGER,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$TOTAL_HITS INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsSearchMulti'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$SEARCH_MULTI IS
+'Performs a full-text search at several indexes and returns the hits ranked together.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$INDEX_NAMES IS
+'Comma separated list of the full-text indexes to search.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$LIMIT IS
+'Limit on the number of records (search result).';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$INDEX_NAME IS
+'The name of the index in which the document is found.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$RELATION_NAME IS
+'The name of the table in which the document is found.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$DB_KEY IS
+'Reference to the record in the table where the document was found (corresponds to the RDB$DB_KEY pseudo field).';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$SCORE IS
+'The degree of match to the search query.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$TOTAL_HITS IS
+'Total number of documents matching the query in all indexes, regardless of the limit';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH_MULTI;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH_MULTI;
+
+CREATE OR ALTER FUNCTION FTS$SEARCH_COUNT (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8
+)
+RETURNS INTEGER
+EXTERNAL NAME 'luceneudr!ftsSearchCount'
+ENGINE UDR;
+
+COMMENT ON FUNCTION FTS$SEARCH_COUNT IS
+'Returns the number of documents matching the full-text search query.';
+
+COMMENT ON PARAMETER FTS$SEARCH_COUNT.FTS$INDEX_NAME IS
+'Name of the full-text index to search.';
+
+COMMENT ON PARAMETER FTS$SEARCH_COUNT.FTS$QUERY IS
+'Full text search expression.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO FUNCTION FTS$SEARCH_COUNT;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO FUNCTION FTS$SEARCH_COUNT;
+
+CREATE OR ALTER PROCEDURE FTS$FACETS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$TOP_N INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$VALUE VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$COUNT INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsFacets'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$FACETS IS
+'Returns the most frequent values of a sortable index field among the documents matching the full-text search query.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$INDEX_NAME IS
+'Name of the full-text index to search.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$FIELD_NAME IS
+'Name of the sortable index field whose values are counted.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$TOP_N IS
+'Maximum number of values returned.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$VALUE IS
+'Field value.';
+
+COMMENT ON PARAMETER FTS$FACETS.FTS$COUNT IS
+'Number of matching documents with this field value.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$FACETS;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$FACETS;
+
+CREATE OR ALTER PROCEDURE FTS$SUGGEST (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$PREFIX VARCHAR(255) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$DOC_FREQ INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsSuggest'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$SUGGEST IS
+'Returns the most frequent index terms of a field starting with the specified prefix.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$INDEX_NAME IS
+'Name of the full-text index.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$FIELD_NAME IS
+'Name of the index field whose terms are suggested.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$PREFIX IS
+'Beginning of the term.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$LIMIT IS
+'Maximum number of terms returned.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$TERM IS
+'Index term.';
+
+COMMENT ON PARAMETER FTS$SUGGEST.FTS$DOC_FREQ IS
+'Number of documents containing the term.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SUGGEST;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SUGGEST;
+
+CREATE OR ALTER PROCEDURE FTS$DID_YOU_MEAN (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 5
+)
+RETURNS (
+    FTS$SUGGESTED_QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$DOC_FREQ INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsDidYouMean'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$DID_YOU_MEAN IS
+'Returns the search query with misspelled words replaced by similar words of the index.';
+
+COMMENT ON PARAMETER FTS$DID_YOU_MEAN.FTS$INDEX_NAME IS
+'Name of the full-text index.';
+
+COMMENT ON PARAMETER FTS$DID_YOU_MEAN.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$DID_YOU_MEAN.FTS$LIMIT IS
+'Maximum number of corrected queries returned.';
+
+COMMENT ON PARAMETER FTS$DID_YOU_MEAN.FTS$SUGGESTED_QUERY IS
+'Corrected search expression.';
+
+COMMENT ON PARAMETER FTS$DID_YOU_MEAN.FTS$DOC_FREQ IS
+'Number of documents containing the rarest of the substituted words.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$DID_YOU_MEAN;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$DID_YOU_MEAN;
+
 CREATE OR ALTER PROCEDURE FTS$ANALYZE (
     FTS$TEXT     BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
     FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
@@ -862,6 +1298,35 @@ COMMENT ON PARAMETER FTS$ANALYZE.FTS$ANALYZER IS
 COMMENT ON PARAMETER FTS$ANALYZE.FTS$TERM IS
 'Term';
 
+CREATE OR ALTER PROCEDURE FTS$ANALYZE_BATCH (
+    FTS$SQL      BLOB SUB_TYPE TEXT CHARACTER SET UTF8 NOT NULL,
+    FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
+)
+RETURNS (
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$TF   INTEGER,
+    FTS$DF   INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsAnalyzeBatch' ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$ANALYZE_BATCH IS
+'Splits the texts returned by a SELECT query into terms and returns aggregated term statistics.';
+
+COMMENT ON PARAMETER FTS$ANALYZE_BATCH.FTS$SQL IS
+'SELECT query returning the texts to be analyzed. Each record is treated as a separate document';
+
+COMMENT ON PARAMETER FTS$ANALYZE_BATCH.FTS$ANALYZER IS
+'The analyzer on which the texts are split';
+
+COMMENT ON PARAMETER FTS$ANALYZE_BATCH.FTS$TERM IS
+'Term';
+
+COMMENT ON PARAMETER FTS$ANALYZE_BATCH.FTS$TF IS
+'Total number of occurrences of the term in all texts';
+
+COMMENT ON PARAMETER FTS$ANALYZE_BATCH.FTS$DF IS
+'Number of records in which the term occurs';
+
 CREATE OR ALTER PROCEDURE FTS$UPDATE_INDEXES
 EXTERNAL NAME 'luceneudr!updateFtsIndexes' 
 ENGINE UDR;
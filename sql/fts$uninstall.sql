@@ -16,7 +16,13 @@ DROP PACKAGE FTS$TRIGGER_HELPER;
 DROP PACKAGE FTS$HIGHLIGHTER;
 DROP PACKAGE FTS$STATISTICS;
 DROP PROCEDURE FTS$SEARCH;
+DROP PROCEDURE FTS$SEARCH_MULTI;
+DROP FUNCTION FTS$SEARCH_COUNT;
+DROP PROCEDURE FTS$FACETS;
+DROP PROCEDURE FTS$SUGGEST;
+DROP PROCEDURE FTS$DID_YOU_MEAN;
 DROP PROCEDURE FTS$ANALYZE;
+DROP PROCEDURE FTS$ANALYZE_BATCH;
 DROP PROCEDURE FTS$UPDATE_INDEXES;
 DROP FUNCTION FTS$ESCAPE_QUERY;
 DROP TABLE FTS$LOG;
@@ -0,0 +1,69 @@
+/*
+ * Updates the metadata of an existing database to version 1.5.
+ * After running this script, recreate the package FTS$MANAGEMENT and the
+ * procedure FTS$SEARCH using the statements from fts$install.sql
+ * (fts$install_1.sql for dialect 1), then rebuild the indexes.
+ */
+
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$SORTABLE BOOLEAN DEFAULT FALSE;
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$SORTABLE IS 
+'Can search results be sorted by the field';
+
+ALTER TABLE FTS$ANALYZERS ADD FTS$MIN_GRAM SMALLINT;
+ALTER TABLE FTS$ANALYZERS ADD FTS$MAX_GRAM SMALLINT;
+
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$MIN_GRAM IS 
+'Minimum n-gram length for analyzers based on NGRAM and EDGE_NGRAM';
+
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$MAX_GRAM IS 
+'Maximum n-gram length for analyzers based on NGRAM and EDGE_NGRAM';
+
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$REVERSED BOOLEAN DEFAULT FALSE;
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$REVERSED IS 
+'Are the reversed terms of the field indexed for leading wildcard queries';
+
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$OMIT_NORMS BOOLEAN DEFAULT FALSE;
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$OMIT_POSITIONS BOOLEAN DEFAULT FALSE;
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$TERM_VECTORS BOOLEAN DEFAULT FALSE;
+ALTER TABLE FTS$INDEX_SEGMENTS ADD FTS$NOT_ANALYZED BOOLEAN DEFAULT FALSE;
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$OMIT_NORMS IS 
+'Are length normalization factors and index-time boosts of the field omitted';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$OMIT_POSITIONS IS 
+'Are term frequencies and positions of the field omitted';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$TERM_VECTORS IS 
+'Are term vectors with positions and offsets of the field stored';
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$NOT_ANALYZED IS 
+'Is the whole value of the field indexed as a single term';
+
+ALTER TABLE FTS$INDICES ADD FTS$ALL_FIELD BOOLEAN DEFAULT FALSE;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$ALL_FIELD IS
+'Are all content fields also indexed together in the catch-all field _ALL';
+
+ALTER TABLE FTS$INDICES ADD FTS$SHARD_COUNT SMALLINT DEFAULT 1;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$SHARD_COUNT IS
+'Number of shards the documents of the index are distributed over';
+
+ALTER TABLE FTS$INDICES ADD FTS$PARTITION_FIELD VARCHAR(63) CHARACTER SET UTF8;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARTITION_FIELD IS
+'Field whose values split the documents of the index into partitions';
+
+ALTER TABLE FTS$INDICES ADD FTS$PARTITION_TYPE VARCHAR(10) CHARACTER SET UTF8;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARTITION_TYPE IS
+'Partitioning type: VALUE - a partition per value of the field, MONTH - a partition per month of the date field';
+
+ALTER TABLE FTS$INDICES ADD FTS$REBUILD_CHUNK_SIZE INTEGER;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$REBUILD_CHUNK_SIZE IS
+'Chunk size of a chunked rebuild in progress. Until it completes, changes of the table are kept in FTS$LOG';
+
+COMMIT;
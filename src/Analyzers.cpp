@@ -27,6 +27,8 @@ SELECT
     A.FTS$ANALYZER_NAME
   , A.FTS$BASE_ANALYZER
   , A.FTS$DESCRIPTION
+  , A.FTS$MIN_GRAM
+  , A.FTS$MAX_GRAM
 FROM FTS$ANALYZERS A
 WHERE A.FTS$ANALYZER_NAME = ?
 )SQL";
@@ -52,6 +54,7 @@ SELECT
     W.FTS$WORD
 FROM FTS$STOP_WORDS W
 WHERE W.FTS$ANALYZER_NAME = ?
+ORDER BY W.FTS$WORD
 )SQL";
 
 }
@@ -78,14 +81,16 @@ namespace FTSMetadata
     )
     {
         if (m_analyzerFactory->hasAnalyzer(analyzerName)) {
-            return m_analyzerFactory->createAnalyzer(status, analyzerName);
+            return m_analyzerFactory->getAnalyzer(status, analyzerName);
         }
         const auto info = getAnalyzerInfo(status, att, tra, sqlDialect, analyzerName);
         if (!m_analyzerFactory->hasAnalyzer(info.baseAnalyzer)) {
             throwException(status, R"(Base analyzer "%s" not exists)", info.baseAnalyzer.c_str());
         }
-        const auto stopWords = getStopWords(status, att, tra, sqlDialect, analyzerName);
-        return m_analyzerFactory->createAnalyzer(status, info.baseAnalyzer, stopWords);
+        // The stop words are part of the analyzer definition. 
+        // The pooled instance is reused as long as they have not changed.
+        const auto stopWords = readStopWords(status, att, tra, sqlDialect, analyzerName);
+        return m_analyzerFactory->getAnalyzer(status, analyzerName, info.baseAnalyzer, stopWords, info.gramSizes);
     }
 
     AnalyzerInfo AnalyzerRepository::getAnalyzerInfo(
@@ -109,6 +114,8 @@ namespace FTSMetadata
             (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
             (FB_INTL_VARCHAR(252, CS_UTF8), baseAnalyzer)
             (FB_BLOB, description)
+            (FB_SMALLINT, minGram)
+            (FB_SMALLINT, maxGram)
         ) output(status, m_master);
 
         input.clear();
@@ -144,12 +151,34 @@ namespace FTSMetadata
             throwException(status, R"(Analyzer "%s" not exists)", sAnalyzerName.c_str());
         }
 
-        return {
+        AnalyzerInfo info(
             std::string_view(output->analyzerName.str, output->analyzerName.length),
             std::string_view(output->baseAnalyzer.str, output->baseAnalyzer.length),
             m_analyzerFactory->isStopWordsSupported(std::string_view(output->baseAnalyzer.str, output->baseAnalyzer.length)),
             false
-        };
+        );
+        if (!output->minGramNull) {
+            info.gramSizes.minGram = output->minGram;
+        }
+        if (!output->maxGramNull) {
+            info.gramSizes.maxGram = output->maxGram;
+        }
+        return info;
+    }
+
+    bool AnalyzerRepository::isWordPreserving (
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view analyzerName
+    )
+    {
+        if (m_analyzerFactory->hasAnalyzer(analyzerName)) {
+            return m_analyzerFactory->isWordPreserving(analyzerName);
+        }
+        const auto info = getAnalyzerInfo(status, att, tra, sqlDialect, analyzerName);
+        return m_analyzerFactory->isWordPreserving(info.baseAnalyzer);
     }
 
     bool AnalyzerRepository::hasAnalyzer (
@@ -218,6 +247,21 @@ namespace FTSMetadata
             return m_analyzerFactory->getAnalyzerStopWords(status, analyzerName);
         }
 
+        auto stopWords = HashSet<String>::newInstance();
+        for (const auto& stopWord : readStopWords(status, att, tra, sqlDialect, analyzerName)) {
+            stopWords.add(StringUtils::toUnicode(stopWord));
+        }
+        return stopWords;
+    }
+
+    std::vector<std::string> AnalyzerRepository::readStopWords(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view analyzerName
+    )
+    {
         FB_MESSAGE(Input, ThrowStatusWrapper,
             (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
         ) input(status, m_master);
@@ -231,8 +275,8 @@ namespace FTSMetadata
         input->analyzerName.length = static_cast<ISC_USHORT>(analyzerName.length());
         analyzerName.copy(input->analyzerName.str, input->analyzerName.length);
 
-        auto stopWords = HashSet<String>::newInstance();
-        
+        std::vector<std::string> stopWords;
+
         if (!m_stmt_get_stopwords.hasData()) {
             m_stmt_get_stopwords.reset(att->prepare(
                 status,
@@ -254,9 +298,7 @@ namespace FTSMetadata
         ));
         
         while (rs->fetchNext(status, output.getData()) == IStatus::RESULT_OK) {
-            const std::string stopWord(output->stopWord.str, output->stopWord.length);
-            const String uStopWord = StringUtils::toUnicode(stopWord);
-            stopWords.add(uStopWord);
+            stopWords.emplace_back(output->stopWord.str, output->stopWord.length);
         }
         rs->close(status);
         rs.release();
@@ -16,6 +16,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
@@ -72,6 +73,18 @@ namespace FTSMetadata
             std::string_view analyzerName
         );
 
+        /// <summary>
+        /// Returns whether the terms of the analyzer are the words of the text. 
+        /// A custom analyzer is checked by its base analyzer.
+        /// </summary>
+        bool isWordPreserving (
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view analyzerName
+        );
+
         bool hasAnalyzer (
             Firebird::ThrowStatusWrapper* status,
             Firebird::IAttachment* att,
@@ -87,6 +100,15 @@ namespace FTSMetadata
             unsigned int sqlDialect,
             std::string_view analyzerName
         );
+
+    private:
+        std::vector<std::string> readStopWords (
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view analyzerName
+        );
     };
 }
 
@@ -0,0 +1,60 @@
+/**
+ *  Collector that gathers matching documents into a bit set.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "DocSetCollector.h"
+
+namespace Lucene 
+{
+
+    DocSetCollector::DocSetCollector(int32_t maxDoc)
+        : docs(newLucene<OpenBitSet>(maxDoc))
+        , docBase(0)
+        , totalHits(0)
+    {
+    }
+
+    DocSetCollector::~DocSetCollector() {
+    }
+
+    OpenBitSetPtr DocSetCollector::getDocs() const
+    {
+        return docs;
+    }
+
+    int64_t DocSetCollector::getTotalHits() const
+    {
+        return totalHits;
+    }
+
+    void DocSetCollector::setScorer([[maybe_unused]] const ScorerPtr& scorer)
+    {
+        // scores are not needed
+    }
+
+    void DocSetCollector::collect(int32_t doc)
+    {
+        docs->fastSet(docBase + doc);
+        ++totalHits;
+    }
+
+    void DocSetCollector::setNextReader([[maybe_unused]] const IndexReaderPtr& reader, int32_t docBase)
+    {
+        this->docBase = docBase;
+    }
+
+    bool DocSetCollector::acceptsDocsOutOfOrder()
+    {
+        return true;
+    }
+
+}
@@ -0,0 +1,55 @@
+#ifndef DOC_SET_COLLECTOR_H
+#define DOC_SET_COLLECTOR_H
+
+/**
+ *  Collector that gathers matching documents into a bit set.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Collector.h"
+#include "OpenBitSet.h"
+
+namespace Lucene 
+{
+    /// Marks the documents matching a query in a bit set indexed by top-level document number. 
+    /// Scores are never computed and documents are accepted out of order.
+    class DocSetCollector : public Collector {
+    public:
+        /// @param maxDoc number of documents in the top-level reader
+        DocSetCollector(int32_t maxDoc);
+
+        virtual ~DocSetCollector();
+
+        LUCENE_CLASS(DocSetCollector);
+
+    protected:
+        OpenBitSetPtr docs;
+        int32_t docBase;
+        int64_t totalHits;
+
+    public:
+        /// Returns the set of collected top-level document numbers.
+        OpenBitSetPtr getDocs() const;
+
+        /// Returns the number of documents collected.
+        int64_t getTotalHits() const;
+
+        virtual void setScorer(const ScorerPtr& scorer);
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+        virtual bool acceptsDocsOutOfOrder();
+    };
+
+    typedef boost::shared_ptr<DocSetCollector> DocSetCollectorPtr;
+}
+
+#endif // DOC_SET_COLLECTOR_H
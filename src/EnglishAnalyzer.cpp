@@ -15,7 +15,6 @@
 
 #include "WordlistLoader.h"
 #include "StandardAnalyzer.h"
-#include "PorterStemFilter.h"
 
 namespace Lucene 
 {
@@ -44,6 +43,7 @@ namespace Lucene
 
     void EnglishAnalyzer::ConstructAnalyser(LuceneVersion::Version matchVersion, HashSet<String> stopWords) {
         stopSet = stopWords;
+        flatStopSet = std::make_shared<const FlatStopSet>(stopWords);
         enableStopPositionIncrements = StopFilter::getEnablePositionIncrementsVersionDefault(matchVersion);
         replaceInvalidAcronym = LuceneVersion::onOrAfter(matchVersion, LuceneVersion::LUCENE_24);
         this->matchVersion = matchVersion;
@@ -56,16 +56,14 @@ namespace Lucene
         return StopAnalyzer::ENGLISH_STOP_WORDS_SET();
     }
 
-    /// Constructs a {@link StandardTokenizer} filtered by a {@link StandardFilter}, a {@link LowerCaseFilter}
-    /// a {@link StopFilter} and a {@link PorterStemFilter}.
+    /// Constructs a {@link StandardTokenizer} filtered by a {@link StandardFilter} and a {@link EnglishStemStopFilter},
+    /// which is equivalent to a {@link LowerCaseFilter}, a {@link StopFilter} and a {@link PorterStemFilter}.
     TokenStreamPtr EnglishAnalyzer::tokenStream([[maybe_unused]] const String& fieldName, const ReaderPtr& reader)
     {
         StandardTokenizerPtr tokenStream(newLucene<StandardTokenizer>(matchVersion, reader));
         tokenStream->setMaxTokenLength(maxTokenLength);
         TokenStreamPtr result(newLucene<StandardFilter>(tokenStream));
-        result = newLucene<LowerCaseFilter>(result);
-        result = newLucene<StopFilter>(enableStopPositionIncrements, result, stopSet);
-        result = newLucene<PorterStemFilter>(result);
+        result = newLucene<EnglishStemStopFilter>(enableStopPositionIncrements, result, flatStopSet);
         return result;
     }
 
@@ -84,9 +82,7 @@ namespace Lucene
             setPreviousTokenStream(streams);
             streams->tokenStream = newLucene<StandardTokenizer>(matchVersion, reader);
             streams->filteredTokenStream = newLucene<StandardFilter>(streams->tokenStream);
-            streams->filteredTokenStream = newLucene<LowerCaseFilter>(streams->filteredTokenStream);
-            streams->filteredTokenStream = newLucene<StopFilter>(enableStopPositionIncrements, streams->filteredTokenStream, stopSet);
-            streams->filteredTokenStream = newLucene<PorterStemFilter>(streams->filteredTokenStream);
+            streams->filteredTokenStream = newLucene<EnglishStemStopFilter>(enableStopPositionIncrements, streams->filteredTokenStream, flatStopSet);
         }
         else {
             streams->tokenStream->reset(reader);
@@ -15,6 +15,7 @@
 **/
 #include "LuceneHeaders.h"
 #include "Analyzer.h"
+#include "EnglishStemStopFilter.h"
 
 namespace Lucene 
 {
@@ -51,6 +52,8 @@ namespace Lucene
 
     protected:
         HashSet<String> stopSet;
+        /// Stop words prepared for fast lookup, built once per analyzer instance.
+        FlatStopSetPtr flatStopSet;
 
         /// Specifies whether deprecated acronyms should be replaced with HOST type.
         bool replaceInvalidAcronym;
@@ -68,8 +71,8 @@ namespace Lucene
         /// Returns an unmodifiable instance of the default stop-words set.
         static const HashSet<String> getDefaultStopSet();
 
-        /// Constructs a {@link StandardTokenizer} filtered by a {@link StandardFilter}, a {@link LowerCaseFilter}
-        /// a {@link StopFilter} and a {@link PorterStemFilter}.
+        /// Constructs a {@link StandardTokenizer} filtered by a {@link StandardFilter} and a {@link EnglishStemStopFilter},
+        /// which is equivalent to a {@link LowerCaseFilter}, a {@link StopFilter} and a {@link PorterStemFilter}.
         TokenStreamPtr tokenStream(const String& fieldName, const ReaderPtr& reader);
 
         /// Set maximum allowed token length.  If a token is seen that exceeds this length then it is discarded.  This setting
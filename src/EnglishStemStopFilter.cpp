@@ -0,0 +1,130 @@
+/**
+ *  Fused lowercase, stop words and Porter stemming filter for EnglishAnalyzer.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "EnglishStemStopFilter.h"
+
+#include <cwchar>
+
+#include "CharFolder.h"
+#include "PorterStemmer.h"
+#include "PositionIncrementAttribute.h"
+#include "TermAttribute.h"
+
+namespace Lucene 
+{
+
+    FlatStopSet::FlatStopSet(const HashSet<String>& stopWords)
+    {
+        // load factor not more than 0.5
+        size_t capacity = 16;
+        while (capacity < stopWords.size() * 2) {
+            capacity <<= 1;
+        }
+        m_slots.resize(capacity);
+        m_mask = static_cast<uint32_t>(capacity - 1);
+
+        for (const auto& word : stopWords) {
+            uint32_t hash = HASH_INIT;
+            for (const auto ch : word) {
+                hash = hashChar(hash, ch);
+            }
+            const auto length = static_cast<int32_t>(word.length());
+            if (contains(word.c_str(), length, hash)) {
+                continue;
+            }
+            uint32_t pos = hash & m_mask;
+            while (m_slots[pos].length >= 0) {
+                pos = (pos + 1) & m_mask;
+            }
+            auto& slot = m_slots[pos];
+            slot.hash = hash;
+            slot.offset = static_cast<uint32_t>(m_chars.size());
+            slot.length = length;
+            m_chars.insert(m_chars.end(), word.begin(), word.end());
+            ++m_size;
+        }
+    }
+
+    bool FlatStopSet::contains(const wchar_t* term, int32_t length, uint32_t hash) const
+    {
+        uint32_t pos = hash & m_mask;
+        for (;;) {
+            const auto& slot = m_slots[pos];
+            if (slot.length < 0) {
+                return false;
+            }
+            if (slot.hash == hash && slot.length == length &&
+                std::wmemcmp(m_chars.data() + slot.offset, term, length) == 0) 
+            {
+                return true;
+            }
+            pos = (pos + 1) & m_mask;
+        }
+    }
+
+    bool FlatStopSet::contains(const wchar_t* term, int32_t length) const
+    {
+        uint32_t hash = HASH_INIT;
+        for (int32_t i = 0; i < length; i++) {
+            hash = hashChar(hash, term[i]);
+        }
+        return contains(term, length, hash);
+    }
+
+    EnglishStemStopFilter::EnglishStemStopFilter(bool enablePositionIncrements, const TokenStreamPtr& input, const FlatStopSetPtr& stopSet)
+        : TokenFilter(input)
+        , stopSet(stopSet)
+        , enablePositionIncrements(enablePositionIncrements)
+        , stemmer(newLucene<PorterStemmer>())
+    {
+        termAtt = addAttribute<TermAttribute>();
+        posIncrAtt = addAttribute<PositionIncrementAttribute>();
+    }
+
+    EnglishStemStopFilter::~EnglishStemStopFilter() {
+    }
+
+    bool EnglishStemStopFilter::incrementToken() 
+    {
+        int32_t skippedPositions = 0;
+        while (input->incrementToken()) {
+            wchar_t* buffer = termAtt->termBufferArray();
+            const int32_t length = termAtt->termLength();
+
+            // lowercase the term in place and hash it in the same pass
+            uint32_t hash = FlatStopSet::HASH_INIT;
+            for (int32_t i = 0; i < length; i++) {
+                const wchar_t ch = CharFolder::toLower(buffer[i]);
+                buffer[i] = ch;
+                hash = FlatStopSet::hashChar(hash, ch);
+            }
+
+            if (stopSet->contains(buffer, length, hash)) {
+                skippedPositions += posIncrAtt->getPositionIncrement();
+                continue;
+            }
+
+            if (enablePositionIncrements) {
+                posIncrAtt->setPositionIncrement(posIncrAtt->getPositionIncrement() + skippedPositions);
+            }
+
+            // the stemmer takes the index of the last character of the word
+            if (stemmer->stem(buffer, length - 1)) {
+                termAtt->setTermBuffer(stemmer->getResultBuffer(), 0, stemmer->getResultLength());
+            }
+            return true;
+        }
+        return false;
+    }
+
+}
@@ -0,0 +1,88 @@
+#ifndef ENGLISH_STEM_STOP_FILTER_H
+#define ENGLISH_STEM_STOP_FILTER_H
+
+/**
+ *  Fused lowercase, stop words and Porter stemming filter for EnglishAnalyzer.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "LuceneHeaders.h"
+#include "TokenFilter.h"
+
+namespace Lucene 
+{
+    /// Immutable set of stop words with open addressing and linear probing.
+    /// All words are kept in one contiguous character pool, so a probe does not allocate
+    /// and touches at most a few cache lines.
+    class FlatStopSet {
+    public:
+        explicit FlatStopSet(const HashSet<String>& stopWords);
+
+        /// Hash of the term, must be computed the same way as the term is probed.
+        static uint32_t hashChar(uint32_t h, wchar_t ch)
+        {
+            return (h ^ static_cast<uint32_t>(ch)) * 16777619u;
+        }
+
+        static constexpr uint32_t HASH_INIT = 2166136261u;
+
+        bool contains(const wchar_t* term, int32_t length, uint32_t hash) const;
+
+        bool contains(const wchar_t* term, int32_t length) const;
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+    private:
+        struct Slot {
+            uint32_t hash = 0;
+            uint32_t offset = 0;
+            int32_t length = -1;  // -1 - empty slot
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<wchar_t> m_chars;
+        uint32_t m_mask = 0;
+        size_t m_size = 0;
+    };
+
+    using FlatStopSetPtr = std::shared_ptr<const FlatStopSet>;
+
+    /// Equivalent of the LowerCaseFilter -> StopFilter -> PorterStemFilter chain 
+    /// performed in one pass over the term buffer.
+    class EnglishStemStopFilter : public TokenFilter {
+    public:
+        EnglishStemStopFilter(bool enablePositionIncrements, const TokenStreamPtr& input, const FlatStopSetPtr& stopSet);
+
+        virtual ~EnglishStemStopFilter();
+
+        LUCENE_CLASS(EnglishStemStopFilter);
+
+    protected:
+        FlatStopSetPtr stopSet;
+        bool enablePositionIncrements;
+        PorterStemmerPtr stemmer;
+        TermAttributePtr termAtt;
+        PositionIncrementAttributePtr posIncrAtt;
+
+    public:
+        virtual bool incrementToken();
+    };
+
+}
+
+#endif // ENGLISH_STEM_STOP_FILTER_H
@@ -37,6 +37,7 @@ namespace FTSMetadata
         , ftsBoost{1.0}
         , ftsBoostNull(true)
         , ftsKey(false)
+        , ftsSortType(FTSSortType::NONE)
         , nullable(meta->isNullable(status, index))
     {
     }
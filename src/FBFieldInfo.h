@@ -23,6 +23,36 @@
 namespace FTSMetadata
 {
 
+    /// <summary>
+    /// How the values of a sortable field are indexed for sorting.
+    /// </summary>
+    enum class FTSSortType { NONE, STRING, LONG, DOUBLE };
+
+    /// <summary>
+    /// Returns the sort type for a field of the given SQL type. 
+    /// Integers are sorted as LONG, other numbers as DOUBLE, everything else as untokenized strings.
+    /// </summary>
+    inline FTSSortType sortTypeFromSqlType(unsigned sqlType, int scale)
+    {
+        switch (sqlType & ~1u) {
+        case SQL_SHORT:
+        case SQL_LONG:
+        case SQL_INT64:
+            return (scale == 0) ? FTSSortType::LONG : FTSSortType::DOUBLE;
+        case SQL_FLOAT:
+        case SQL_D_FLOAT:
+        case SQL_DOUBLE:
+#if FB_API_VER >= 40
+        case SQL_INT128:
+        case SQL_DEC16:
+        case SQL_DEC34:
+#endif
+            return FTSSortType::DOUBLE;
+        default:
+            return FTSSortType::STRING;
+        }
+    }
+
     class FbFieldInfo {
     public:
         std::string fieldName;
@@ -43,6 +73,12 @@ namespace FTSMetadata
         double ftsBoost = 1.0;
         bool ftsBoostNull = true;
         bool ftsKey = false;
+        FTSSortType ftsSortType = FTSSortType::NONE;
+        bool ftsReversed = false;
+        bool ftsOmitNorms = false;
+        bool ftsOmitPositions = false;
+        bool ftsTermVectors = false;
+        bool ftsNotAnalyzed = false;
 
         bool nullable = false;
 
@@ -98,9 +98,17 @@ namespace LuceneUDR
         if (!blobIdPtr) {
             return {};
         }
+        AutoRelease<IBlob> blob(att->openBlob(status, tra, blobIdPtr, 0, nullptr));
+        std::string s = readStringFromBlob(status, blob);
+        blob->close(status);
+        blob.release();
+        return s;
+    }
+
+    std::string readStringFromBlob(Firebird::ThrowStatusWrapper* status, Firebird::IBlob* blob)
+    {
         std::string s;
         s.reserve(MAX_SEGMENT_SIZE);
-        AutoRelease<IBlob> blob(att->openBlob(status, tra, blobIdPtr, 0, nullptr));
         auto buffer = std::vector<char>(MAX_SEGMENT_SIZE);
         {
             bool eof = false;
@@ -117,8 +125,6 @@ namespace LuceneUDR
                 }
             }
         }
-        blob->close(status);
-        blob.release();
         return s;
     }
 
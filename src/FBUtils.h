@@ -31,6 +31,11 @@ namespace LuceneUDR
     std::string readStringFromBlob(Firebird::ThrowStatusWrapper* status, Firebird::IAttachment* att, 
         Firebird::ITransaction* tra, ISC_QUAD* blobIdPtr);
 
+    /// <summary>
+    /// Reads all remaining segments of an open BLOB into a string. The BLOB is not closed.
+    /// </summary>
+    std::string readStringFromBlob(Firebird::ThrowStatusWrapper* status, Firebird::IBlob* blob);
+
     void writeStringToBlob(Firebird::ThrowStatusWrapper* status, Firebird::IAttachment* att, 
         Firebird::ITransaction* tra, ISC_QUAD* blobIdPtr, std::string_view str);
 
@@ -11,20 +11,48 @@
  *  Contributor(s): ______________________________________.
 **/
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "Analyzers.h"
+#include "DocSetCollector.h"
+#include "FBFieldInfo.h"
 #include "FBUtils.h"
 #include "FTSHelper.h"
 #include "FTSIndex.h"
 #include "FTSUtils.h"
+#include "HitCountCollector.h"
+#include "IndexDirectory.h"
 #include "LuceneAnalyzerFactory.h"
 #include "LuceneUdr.h"
 #include "LuceneHeaders.h"
+#include "NGramAnalyzer.h"
 #include "Relations.h"
+#include "ReverseFieldAnalyzer.h"
+#include "SearchLimits.h"
+#include "SpellIndex.h"
+#include "TermSuggester.h"
 #include "TermAttribute.h"
+#include "OffsetAttribute.h"
+#include "FieldCache.h"
+#include "NumericUtils.h"
+#include "PerFieldAnalyzerWrapper.h"
+#include "MultiReader.h"
+#include "MultiSearcher.h"
+#include "ParallelMultiSearcher.h"
+#include "TimeLimitingCollector.h"
+#include "ThreadPool.h"
+#include "HitQueue.h"
+#include "FieldDoc.h"
+#include "FieldDocSortedHitQueue.h"
 
 
 
@@ -35,37 +63,548 @@ using namespace LuceneUDR;
 
 namespace {
 
-    std::string queryEscape(std::string_view query)
-    {
-        std::string s;
-        s.reserve(query.size());
-        for (auto ch : query) {
-            switch (ch) {
-            case '+':
-            case '-':
-            case '!':
-            case '^':
-            case '"':
-            case '~':
-            case '*':
-            case '?':
-            case ':':
-            case '\\':
-            case '&':
-            case '|':
-            case '(':
-            case ')':
-            case '[':
-            case ']':
-            case '{':
-            case '}':
-                s+= '\\' + ch;
+    /// <summary>
+    /// Returns the number of characters of a UTF-8 string.
+    /// </summary>
+    size_t getCharLength(std::string_view str)
+    {
+        return std::count_if(str.cbegin(), str.cend(), [](char c) {
+            return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        });
+    }
+
+    /// <summary>
+    /// Returns the path to the directory of the current generation of a full-text index. 
+    /// Throws an error if the index has not been built.
+    /// </summary>
+    fs::path getBuiltIndexDirectoryPath(ThrowStatusWrapper* status, const FtsConfig& ftsConfig, const FTSIndex& ftsIndex)
+    {
+        const auto indexDirectoryPath = getIndexGenerationPath(ftsConfig.ftsDirectory / ftsIndex.indexName);
+        if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
+            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", ftsIndex.indexName.c_str());
+        }
+        return indexDirectoryPath;
+    }
+
+    Collection<DirectoryPtr> openShardDirectories(
+        ThrowStatusWrapper* status,
+        const FtsConfig& ftsConfig,
+        const FTSIndex& ftsIndex,
+        const std::vector<fs::path>& shardPaths)
+    {
+        auto directories = Collection<DirectoryPtr>::newInstance();
+        for (const auto& shardPath : shardPaths) {
+            auto ftsIndexDir = openIndexDirectory(status, ftsConfig, ftsIndex.indexName, shardPath);
+            if (!IndexReader::indexExists(ftsIndexDir)) {
+                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", ftsIndex.indexName.c_str());
+            }
+            directories.add(ftsIndexDir);
+        }
+        return directories;
+    }
+
+    /// <summary>
+    /// Opens the directories of all shards of a full-text index for searching. 
+    /// If a partition is given, only the shards of this partition are opened, 
+    /// there are none if the partition has no documents.
+    /// Throws an error if the index has not been built.
+    /// </summary>
+    Collection<DirectoryPtr> openSearchDirectories(
+        ThrowStatusWrapper* status, 
+        const FtsConfig& ftsConfig, 
+        const FTSIndex& ftsIndex, 
+        const std::optional<std::string>& partition = std::nullopt)
+    {
+        const auto indexDirectoryPath = getBuiltIndexDirectoryPath(status, ftsConfig, ftsIndex);
+        std::vector<fs::path> shardPaths;
+        if (!partition) {
+            shardPaths = getAllIndexShardPaths(indexDirectoryPath, ftsIndex.shardCount, ftsIndex.isPartitioned());
+        }
+        else if (!isIndexPartitioned(indexDirectoryPath, ftsIndex.isPartitioned())) {
+            throwException(status, R"(Index "%s" is not partitioned.)", ftsIndex.indexName.c_str());
+        }
+        else {
+            // a date selects its month in an index partitioned by month
+            const auto partitionPath = getIndexPartitionPath(indexDirectoryPath, 
+                ftsIndex.isPartitionedByMonth() ? getMonthPartitionValue(status, *partition) : *partition);
+            if (fs::is_directory(partitionPath)) {
+                shardPaths = getIndexShardPaths(partitionPath, ftsIndex.shardCount);
+            }
+        }
+        return openShardDirectories(status, ftsConfig, ftsIndex, shardPaths);
+    }
+
+    /// <summary>
+    /// Checks whether the search results are sorted by the date of an index partitioned by month, newest first, 
+    /// and the index is built with this partitioning. Such a search scans the months from the newest one.
+    /// </summary>
+    bool isRecentFirstSearch(const FtsConfig& ftsConfig, const FTSIndex& ftsIndex, const SortPtr& sort)
+    {
+        if (!sort || !ftsIndex.isPartitionedByMonth()) {
+            return false;
+        }
+        const auto& sortField = sort->getSort()[0];
+        if (!sortField->getReverse() || sortField->getField() != getSortFieldName(StringUtils::toUnicode(ftsIndex.partitionField))) {
+            return false;
+        }
+        return getIndexPartitioning(getIndexGenerationPath(ftsConfig.ftsDirectory / ftsIndex.indexName)) == ftsIndex.partitioning();
+    }
+
+    /// <summary>
+    /// Opens the directories of the shards of each month of an index partitioned by month, the newest month first.
+    /// Throws an error if the index has not been built.
+    /// </summary>
+    std::vector<Collection<DirectoryPtr>> openRecentFirstDirectories(
+        ThrowStatusWrapper* status,
+        const FtsConfig& ftsConfig,
+        const FTSIndex& ftsIndex)
+    {
+        const auto indexDirectoryPath = getBuiltIndexDirectoryPath(status, ftsConfig, ftsIndex);
+        auto partitionPaths = getIndexPartitionPaths(indexDirectoryPath);
+        // partitions named YYYY-MM sort in chronological order, documents without a date are in the first one
+        std::reverse(partitionPaths.begin(), partitionPaths.end());
+        std::vector<Collection<DirectoryPtr>> directories;
+        directories.reserve(partitionPaths.size());
+        for (const auto& partitionPath : partitionPaths) {
+            directories.push_back(openShardDirectories(status, ftsConfig, ftsIndex, getIndexShardPaths(partitionPath, ftsIndex.shardCount)));
+        }
+        return directories;
+    }
+
+    /// <summary>
+    /// Searches the months of an index partitioned by month one by one from the newest, 
+    /// while the results are sorted by the date in descending order. All hits of a newer month precede 
+    /// the hits of older ones, so the search stops as soon as the requested number of hits is collected. 
+    /// The total number of hits then counts only the searched months.
+    /// </summary>
+    ///
+    /// <param name="searcher">Searcher over all months in the same order, the hits are numbered as its documents</param>
+    /// <param name="partitionSearchers">Searchers of the months, newest first</param>
+    TopDocsPtr searchRecentFirst(
+        const SearcherPtr& searcher,
+        const Collection<SearchablePtr>& partitionSearchers,
+        const QueryPtr& query,
+        const SortPtr& sort,
+        int32_t numHits,
+        int64_t timeout,
+        bool& timedOut)
+    {
+        // the scores use the term statistics of all months, as a search over the whole index does
+        const auto weight = query->weight(searcher);
+        const auto startTime = std::chrono::steady_clock::now();
+        auto scoreDocs = Collection<ScoreDocPtr>::newInstance();
+        int32_t totalHits = 0;
+        int32_t docBase = 0;
+        for (const auto& partitionSearcher : partitionSearchers) {
+            if (scoreDocs.size() >= numHits) {
+                break;
+            }
+            const int32_t maxDoc = partitionSearcher->maxDoc();
+            const int32_t partitionHits = std::min(numHits - scoreDocs.size(), maxDoc);
+            if (partitionHits > 0) {
+                TopDocsCollectorPtr topDocsCollector = TopFieldCollector::create(sort, partitionHits, true, true, false, true);
+                if (timeout > 0) {
+                    const int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime).count();
+                    if (elapsed >= timeout) {
+                        timedOut = true;
+                        break;
+                    }
+                    auto timeLimitingCollector = newLucene<TimeLimitingCollector>(topDocsCollector, timeout - elapsed);
+                    try {
+                        partitionSearcher->search(weight, FilterPtr(), timeLimitingCollector);
+                    }
+                    catch (const TimeExceededException&) {
+                        timedOut = true;
+                    }
+                }
+                else {
+                    partitionSearcher->search(weight, FilterPtr(), topDocsCollector);
+                }
+                auto partitionDocs = topDocsCollector->topDocs();
+                totalHits += partitionDocs->totalHits;
+                for (const auto& scoreDoc : partitionDocs->scoreDocs) {
+                    scoreDoc->doc += docBase;
+                    scoreDocs.add(scoreDoc);
+                }
+            }
+            if (timedOut) {
+                break;
+            }
+            docBase += maxDoc;
+        }
+        return newLucene<TopDocs>(totalHits, scoreDocs);
+    }
+
+    /// <summary>
+    /// Searches the shards of an index in parallel with a time limit and merges their top hits, 
+    /// as ParallelMultiSearcher does without one. Collectors are not thread-safe, so each shard fills its own, 
+    /// which stops once the time is exceeded and keeps the hits collected so far.
+    /// </summary>
+    TopDocsPtr searchShardsWithTimeout(
+        const SearcherPtr& searcher,
+        const Collection<SearchablePtr>& shardSearchers,
+        const QueryPtr& query,
+        const SortPtr& sort,
+        int32_t numHits,
+        int64_t timeout,
+        bool& timedOut)
+    {
+        // the scores use the term statistics of all shards
+        const auto weight = query->weight(searcher);
+        std::vector<TopDocsPtr> shardDocs(shardSearchers.size());
+        std::vector<std::string> shardErrors(shardSearchers.size());
+        std::atomic<bool> shardTimedOut{ false };
+        auto threadPool = ThreadPool::getInstance();
+        auto futures = Collection<FuturePtr>::newInstance();
+        for (int32_t shard = 0; shard < shardSearchers.size(); ++shard) {
+            // the tasks must not throw, the errors are reported once all shards are done
+            futures.add(threadPool->scheduleTask([&, shard]() -> bool {
+                try {
+                    const auto& shardSearcher = shardSearchers[shard];
+                    const int32_t shardHits = std::max(1, std::min(numHits, shardSearcher->maxDoc()));
+                    TopDocsCollectorPtr topDocsCollector;
+                    if (sort) {
+                        topDocsCollector = TopFieldCollector::create(sort, shardHits, true, true, false, true);
+                    }
+                    else {
+                        topDocsCollector = TopScoreDocCollector::create(shardHits, true);
+                    }
+                    auto timeLimitingCollector = newLucene<TimeLimitingCollector>(topDocsCollector, timeout);
+                    try {
+                        shardSearcher->search(weight, FilterPtr(), timeLimitingCollector);
+                    }
+                    catch (const TimeExceededException&) {
+                        shardTimedOut = true;
+                    }
+                    shardDocs[shard] = topDocsCollector->topDocs();
+                }
+                catch (const LuceneException& e) {
+                    shardErrors[shard] = StringUtils::toUTF8(e.getError());
+                }
+                return true;
+            }));
+        }
+        for (const auto& future : futures) {
+            future->get<bool>();
+        }
+        for (const auto& error : shardErrors) {
+            if (!error.empty()) {
+                boost::throw_exception(RuntimeException(StringUtils::toUnicode(error)));
+            }
+        }
+        timedOut = shardTimedOut;
+
+        // the hits are merged as in MultiSearcher, the documents are numbered over all shards
+        int32_t totalHits = 0;
+        double maxScore = -std::numeric_limits<double>::infinity();
+        int32_t docBase = 0;
+        if (sort) {
+            auto hitQueue = newLucene<FieldDocSortedHitQueue>(numHits);
+            for (size_t shard = 0; shard < shardDocs.size(); ++shard) {
+                auto topFieldDocs = boost::static_pointer_cast<TopFieldDocs>(shardDocs[shard]);
+                totalHits += topFieldDocs->totalHits;
+                maxScore = std::max(maxScore, topFieldDocs->maxScore);
+                hitQueue->setFields(topFieldDocs->fields);
+                for (const auto& scoreDoc : topFieldDocs->scoreDocs) {
+                    auto fieldDoc = boost::static_pointer_cast<FieldDoc>(scoreDoc);
+                    fieldDoc->doc += docBase;
+                    // the hits of a shard are sorted, the rest are not competitive
+                    if (fieldDoc == hitQueue->insertWithOverflow(fieldDoc)) {
+                        break;
+                    }
+                }
+                docBase += shardSearchers[static_cast<int32_t>(shard)]->maxDoc();
+            }
+            auto scoreDocs = Collection<ScoreDocPtr>::newInstance(hitQueue->size());
+            for (int32_t i = hitQueue->size() - 1; i >= 0; --i) {
+                scoreDocs[i] = hitQueue->pop();
+            }
+            return newLucene<TopFieldDocs>(totalHits, scoreDocs, hitQueue->getFields(), maxScore);
+        }
+        auto hitQueue = newLucene<HitQueue>(numHits, false);
+        for (size_t shard = 0; shard < shardDocs.size(); ++shard) {
+            totalHits += shardDocs[shard]->totalHits;
+            maxScore = std::max(maxScore, shardDocs[shard]->maxScore);
+            for (const auto& scoreDoc : shardDocs[shard]->scoreDocs) {
+                scoreDoc->doc += docBase;
+                if (scoreDoc == hitQueue->insertWithOverflow(scoreDoc)) {
+                    break;
+                }
+            }
+            docBase += shardSearchers[static_cast<int32_t>(shard)]->maxDoc();
+        }
+        auto scoreDocs = Collection<ScoreDocPtr>::newInstance(hitQueue->size());
+        for (int32_t i = hitQueue->size() - 1; i >= 0; --i) {
+            scoreDocs[i] = hitQueue->pop();
+        }
+        return newLucene<TopDocs>(totalHits, scoreDocs, maxScore);
+    }
+
+    /// <summary>
+    /// Replaces wildcard queries with a leading wildcard over reversed segments 
+    /// by queries over their companion fields of reversed terms. 
+    /// "*ing" becomes the prefix query "gni*", which enumerates only the matching terms 
+    /// instead of the whole term dictionary of the field.
+    /// </summary>
+    QueryPtr rewriteLeadingWildcards(const QueryPtr& query, const std::unordered_set<String>& reversedFields)
+    {
+        if (auto booleanQuery = boost::dynamic_pointer_cast<BooleanQuery>(query)) {
+            for (auto& clause : booleanQuery->getClauses()) {
+                clause->setQuery(rewriteLeadingWildcards(clause->getQuery(), reversedFields));
+            }
+            return booleanQuery;
+        }
+        auto wildcardQuery = boost::dynamic_pointer_cast<WildcardQuery>(query);
+        if (!wildcardQuery) {
+            return query;
+        }
+        const auto term = wildcardQuery->getTerm();
+        const String& text = term->text();
+        if (text.empty() || (text[0] != L'*' && text[0] != L'?') || reversedFields.count(term->field()) == 0) {
+            return query;
+        }
+        const String reversedText = ReverseTermFilter::reverse(text);
+        if (reversedText[0] == L'*' || reversedText[0] == L'?') {
+            // wildcards at both ends, reversing does not help
+            return query;
+        }
+        const String reverseFieldName = getReverseFieldName(term->field());
+        QueryPtr reversedQuery;
+        const auto wildcardPos = reversedText.find_first_of(L"*?");
+        if (wildcardPos == reversedText.length() - 1 && reversedText[wildcardPos] == L'*') {
+            reversedQuery = newLucene<PrefixQuery>(newLucene<Term>(reverseFieldName, reversedText.substr(0, wildcardPos)));
+        }
+        else {
+            reversedQuery = newLucene<WildcardQuery>(newLucene<Term>(reverseFieldName, reversedText));
+        }
+        reversedQuery->setBoost(query->getBoost());
+        return reversedQuery;
+    }
+
+    /// <summary>
+    /// Parses the search query over all non-key fields of the full-text index.
+    /// If the index has the catch-all field, terms without a field name are searched in it only,
+    /// which gives one clause per term instead of one per term and field.
+    /// </summary>
+    QueryPtr parseSearchQuery(const FTSIndex& ftsIndex, const AnalyzerPtr& indexAnalyzer, const std::string& queryStr)
+    {
+        // n-gram analyzers split query words differently from the indexed text
+        AnalyzerPtr analyzer = NGramAnalyzer::getQueryAnalyzer(indexAnalyzer);
+
+        auto fields = Collection<String>::newInstance();
+        std::unordered_set<String> reversedFields;
+        PerFieldAnalyzerWrapperPtr perFieldAnalyzer;
+        for (const auto& segment : ftsIndex.segments) {
+            if (!segment.isKey()) {
+                fields.add(StringUtils::toUnicode(segment.fieldName()));
+                if (segment.isReversed()) {
+                    reversedFields.insert(fields[fields.size() - 1]);
+                }
+                // the values of not analyzed fields are single terms, query terms must match them as is
+                if (segment.isNotAnalyzed()) {
+                    if (!perFieldAnalyzer) {
+                        perFieldAnalyzer = newLucene<PerFieldAnalyzerWrapper>(analyzer);
+                    }
+                    perFieldAnalyzer->addAnalyzer(fields[fields.size() - 1], newLucene<KeywordAnalyzer>());
+                }
+            }
+        }
+        if (perFieldAnalyzer) {
+            analyzer = perFieldAnalyzer;
+        }
+
+        QueryParserPtr parser;
+        if (ftsIndex.allField) {
+            parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, ALL_FIELD_NAME, analyzer);
+        }
+        else if (fields.size() == 1) {
+            parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, fields[0], analyzer);
+        }
+        else {
+            parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, fields, analyzer);
+            parser->setDefaultOperator(QueryParser::OR_OPERATOR);
+        }
+        if (reversedFields.empty()) {
+            return parser->parse(StringUtils::toUnicode(queryStr));
+        }
+        // leading wildcards are allowed only when there are reversed fields to answer them
+        parser->setAllowLeadingWildcard(true);
+        return rewriteLeadingWildcards(parser->parse(StringUtils::toUnicode(queryStr)), reversedFields);
+    }
+
+    /// <summary>
+    /// Returns how the values of a relation field are indexed for sorting. 
+    /// Must agree with sortTypeFromSqlType, which is used when documents are indexed.
+    /// </summary>
+    FTSSortType getSortType(const RelationFieldInfo& fieldInfo)
+    {
+        switch (fieldInfo.fieldType) {
+        case 7:  // SMALLINT
+        case 8:  // INTEGER
+        case 16: // BIGINT
+            return (fieldInfo.fieldScale == 0) ? FTSSortType::LONG : FTSSortType::DOUBLE;
+        case 10: // FLOAT
+        case 11: // D_FLOAT
+        case 24: // DECFLOAT(16)
+        case 25: // DECFLOAT(34)
+        case 26: // INT128
+        case 27: // DOUBLE PRECISION
+            return FTSSortType::DOUBLE;
+        default:
+            return FTSSortType::STRING;
+        }
+    }
+
+    /// <summary>
+    /// Fills the key output fields (FTS$DB_KEY, FTS$UUID or FTS$ID) of a search procedure 
+    /// from the key stored in the found document.
+    /// </summary>
+    template <class OutMessage>
+    void setSearchResultKey(
+        ThrowStatusWrapper* status,
+        OutMessage* out,
+        const DocumentPtr& doc,
+        const String& unicodeKeyFieldName,
+        const RelationFieldInfo& keyFieldInfo)
+    {
+        try {
+            const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
+            if (unicodeKeyFieldName == L"RDB$DB_KEY") {
+                // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
+                auto dbKey = hex_to_binary(keyValue);
+                auto dbKeyPtr = reinterpret_cast<char*>(dbKey.data());
+                out->dbKeyNull = false;
+                out->dbKey.length = static_cast<ISC_USHORT>(dbKey.size());
+                std::copy(dbKeyPtr, dbKeyPtr + out->dbKey.length, out->dbKey.str);
+            }
+            else if (keyFieldInfo.isBinary()) {
+                // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
+                auto uuid = hex_to_binary(keyValue);
+                auto uuidPtr = reinterpret_cast<char*>(uuid.data());
+                out->uuidNull = false;
+                out->uuid.length = static_cast<ISC_USHORT>(uuid.size());
+                std::copy(uuidPtr, uuidPtr + out->uuid.length, out->uuid.str);
+            }
+            else if (keyFieldInfo.isInt()) {
+                out->idNull = false;
+                out->id = std::stoll(keyValue);
+            }
+        }
+        catch (const std::invalid_argument& e) {
+            throwException(status, e.what());
+        }
+    }
+
+    /// <summary>
+    /// Finds a segment of the index by field name. 
+    /// The name is first looked up as is, then in upper case.
+    /// </summary>
+    FTSIndexSegmentList::const_iterator findIndexSegment(const FTSIndex& ftsIndex, const std::string& fieldName)
+    {
+        auto segmentIt = ftsIndex.findSegment(fieldName);
+        if (segmentIt == ftsIndex.segments.end()) {
+            std::string upperFieldName(fieldName);
+            std::transform(upperFieldName.begin(), upperFieldName.end(), upperFieldName.begin(), ::toupper);
+            segmentIt = ftsIndex.findSegment(upperFieldName);
+        }
+        return segmentIt;
+    }
+
+    /// <summary>
+    /// Returns a sortable segment of the index by field name.
+    /// </summary>
+    const FTSIndexSegment& getSortableSegment(ThrowStatusWrapper* status, const FTSIndex& ftsIndex, const std::string& fieldName)
+    {
+        const auto segmentIt = findIndexSegment(ftsIndex, fieldName);
+        if (segmentIt == ftsIndex.segments.end() || !segmentIt->isSortable()) {
+            throwException(status, R"(Field "%s" is not a sortable field of index "%s".)", fieldName.c_str(), ftsIndex.indexName.c_str());
+        }
+        return *segmentIt;
+    }
+
+    /// <summary>
+    /// Converts a term of the companion sort field back to the text of the field value.
+    /// </summary>
+    std::string sortTermToString(FTSSortType sortType, const String& term)
+    {
+        switch (sortType) {
+        case FTSSortType::LONG:
+            return std::to_string(NumericUtils::prefixCodedToLong(term));
+        case FTSSortType::DOUBLE:
+        {
+            std::ostringstream ss;
+            ss.precision(15);
+            ss << NumericUtils::sortableLongToDouble(NumericUtils::prefixCodedToLong(term));
+            return ss.str();
+        }
+        default:
+            return StringUtils::toUTF8(term);
+        }
+    }
+
+    /// <summary>
+    /// Builds the sort order of search results from a specification like "FIELD1 DESC, FIELD2". 
+    /// Only sortable segments of the index and FTS$SCORE can be used.
+    /// </summary>
+    /// 
+    /// <returns>Sort order or nullptr if the specification is empty</returns>
+    SortPtr parseSortSpec(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        RelationHelper* relationHelper,
+        const FTSIndex& ftsIndex,
+        std::string_view sortSpec)
+    {
+        auto sortFields = Collection<SortFieldPtr>::newInstance();
+
+        std::istringstream specStream{ std::string(sortSpec) };
+        std::string item;
+        while (std::getline(specStream, item, ',')) {
+            std::istringstream itemStream(item);
+            std::string fieldName;
+            std::string direction;
+            std::string extra;
+            itemStream >> fieldName >> direction >> extra;
+            if (fieldName.empty()) {
+                continue;
+            }
+            std::transform(direction.begin(), direction.end(), direction.begin(), ::toupper);
+            if (!extra.empty() || !(direction.empty() || direction == "ASC" || direction == "DESC")) {
+                throwException(status, R"(Invalid sort specification "%s".)", item.c_str());
+            }
+            const bool descending = (direction == "DESC");
+
+            std::string upperFieldName(fieldName);
+            std::transform(upperFieldName.begin(), upperFieldName.end(), upperFieldName.begin(), ::toupper);
+            if (upperFieldName == "FTS$SCORE") {
+                // relevance is sorted in descending order by default
+                sortFields.add(newLucene<SortField>(L"", SortField::SCORE, direction == "ASC"));
+                continue;
+            }
+
+            const auto& segment = getSortableSegment(status, ftsIndex, fieldName);
+            const auto fieldInfo = relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, segment.fieldName());
+            const String sortFieldName = getSortFieldName(StringUtils::toUnicode(segment.fieldName()));
+            switch (getSortType(fieldInfo)) {
+            case FTSSortType::LONG:
+                sortFields.add(newLucene<SortField>(sortFieldName, FieldCache::NUMERIC_UTILS_LONG_PARSER(), descending));
+                break;
+            case FTSSortType::DOUBLE:
+                sortFields.add(newLucene<SortField>(sortFieldName, FieldCache::NUMERIC_UTILS_DOUBLE_PARSER(), descending));
                 break;
             default:
-                s += ch;
+                sortFields.add(newLucene<SortField>(sortFieldName, SortField::STRING, descending));
+                break;
             }
         }
-        return s;
+
+        if (sortFields.empty()) {
+            return SortPtr();
+        }
+        return newLucene<Sort>(sortFields);
     }
 }
 
@@ -92,6 +631,13 @@ FB_UDR_BEGIN_FUNCTION(ftsEscapeQuery)
             std::string_view queryStr(in->query.str, in->query.length);
 
             const std::string escapedQuery = queryEscape(queryStr);
+            // each special character takes two characters, the result may not fit the return type
+            const auto escapedLength = std::count_if(escapedQuery.cbegin(), escapedQuery.cend(), [](char c) {
+                return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            });
+            if (escapedLength > 8191) {
+                throwException(status, "Escaped query exceeds 8191 characters");
+            }
 
             out->queryNull = false;
             out->query.length = static_cast<ISC_USHORT>(escapedQuery.length());
@@ -108,7 +654,10 @@ PROCEDURE FTS$SEARCH (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
     FTS$LIMIT INT NOT NULL DEFAULT 1000,
-    FTS$EXPLAIN BOOLEAN DEFAULT FALSE
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$SORT VARCHAR(1024) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$TIMEOUT INT DEFAULT NULL,
+    FTS$PARTITION VARCHAR(255) CHARACTER SET UTF8 DEFAULT NULL
 )
 RETURNS (
     FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
@@ -117,7 +666,9 @@ RETURNS (
     FTS$ID BIGINT,
     FTS$UUID CHAR(16) CHARACTER SET OCTETS,
     FTS$SCORE DOUBLE PRECISION,
-    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$TOTAL_HITS BIGINT,
+    FTS$TIMED_OUT BOOLEAN
 )
 EXTERNAL NAME 'luceneudr!ftsSearch'
 ENGINE UDR;
@@ -128,6 +679,9 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
         (FB_INTL_VARCHAR(32765, CS_UTF8), query)
         (FB_INTEGER, limit)
         (FB_BOOLEAN, explain)
+        (FB_INTL_VARCHAR(4096, CS_UTF8), sort)
+        (FB_INTEGER, timeout)
+        (FB_INTL_VARCHAR(1020, CS_UTF8), partition)
     );
 
     FB_UDR_MESSAGE(OutMessage,
@@ -138,6 +692,8 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
         (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
         (FB_DOUBLE, score)
         (FB_BLOB, explanation)
+        (FB_BIGINT, totalHits)
+        (FB_BOOLEAN, timedOut)
     );
 
     FB_UDR_CONSTRUCTOR
@@ -161,6 +717,9 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
         if (in->indexNameNull) {
             throwException(status, "Index name can not be NULL");
         }
+        if (in->limitNull || in->limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than zero");
+        }
         std::string_view indexName(in->indexName.str, in->indexName.length);
         
         std::string queryStr;
@@ -174,7 +733,7 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
             explainFlag = in->explain;
         }
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
 
         att.reset(context->getAttachment(status));
         tra.reset(context->getTransaction(status));
@@ -183,31 +742,73 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
 
         auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
 
-        // check if directory exists for index
-        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
-        if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
-            std::string sIndexName(indexName);
-            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+        auto limits = getSearchLimits(status, *ftsConfig, ftsIndex.indexName);
+        if (!in->timeoutNull) {
+            if (in->timeout < 0) {
+                throwException(status, "FTS$TIMEOUT can not be negative");
+            }
+            limits.timeout = in->timeout;
+        }
+
+        std::optional<std::string> partition;
+        if (!in->partitionNull) {
+            partition.emplace(in->partition.str, in->partition.length);
         }
 
         try {
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
-            if (!IndexReader::indexExists(ftsIndexDir)) {
-                std::string sIndexName(indexName);
-                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+            SortPtr sort;
+            if (!in->sortNull) {
+                sort = parseSortSpec(status, att, tra, sqlDialect, procedure->indexRepository->getRelationHelper(), ftsIndex, 
+                    std::string_view(in->sort.str, in->sort.length));
+            }
+
+            std::vector<Collection<DirectoryPtr>> partitionDirs;
+            if (!partition && isRecentFirstSearch(*ftsConfig, ftsIndex, sort)) {
+                // the months are searched from the newest one until the top hits are collected
+                partitionDirs = openRecentFirstDirectories(status, *ftsConfig, ftsIndex);
+            }
+            else {
+                // a partitioned index is searched only in the partition of the given value
+                partitionDirs.push_back(openSearchDirectories(status, *ftsConfig, ftsIndex, partition));
             }
 
             const auto analyzers = procedure->indexRepository->getAnalyzerRepository();
             AnalyzerPtr analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
-            searcher = newLucene<IndexSearcher>(ftsIndexDir, true);
+            auto shardReaders = Collection<IndexReaderPtr>::newInstance();
+            auto partitionSearchers = Collection<SearchablePtr>::newInstance();
+            // shards of the last partition, the only one unless the index is searched newest first
+            auto shardSearchers = Collection<SearchablePtr>::newInstance();
+            for (const auto& ftsIndexDirs : partitionDirs) {
+                shardSearchers = Collection<SearchablePtr>::newInstance();
+                for (const auto& ftsIndexDir : ftsIndexDirs) {
+                    auto indexSearcher = newLucene<IndexSearcher>(ftsIndexDir, true);
+                    // sorted hits of the shards are merged by their scores as well
+                    indexSearcher->setDefaultFieldSortScoring(true, true);
+                    shardReaders.add(indexSearcher->getIndexReader());
+                    shardSearchers.add(indexSearcher);
+                }
+                if (shardSearchers.size() > 1) {
+                    // The shards are searched in parallel and their top hits are merged. 
+                    // Term statistics are aggregated over all shards, so the scores do not depend on the sharding.
+                    partitionSearchers.add(newLucene<ParallelMultiSearcher>(shardSearchers));
+                }
+                else if (!shardSearchers.empty()) {
+                    partitionSearchers.add(shardSearchers[0]);
+                }
+            }
+            const bool sharded = shardReaders.size() > 1;
+            const bool recentFirst = partitionSearchers.size() > 1;
+            if (recentFirst) {
+                // numbers the documents of all months for fetching the hits
+                searcher = newLucene<MultiSearcher>(partitionSearchers);
+            }
+            else if (!partitionSearchers.empty()) {
+                searcher = boost::dynamic_pointer_cast<Searcher>(partitionSearchers[0]);
+            }
             
             std::string keyFieldName;
-            auto fields = Collection<String>::newInstance();
             for (const auto& segment : ftsIndex.segments) {
-                if (!segment.isKey()) {
-                    fields.add(StringUtils::toUnicode(segment.fieldName()));
-                }
-                else {
+                if (segment.isKey()) {
                     keyFieldName = segment.fieldName();
                     unicodeKeyFieldName = StringUtils::toUnicode(keyFieldName);
                 }
@@ -215,16 +816,60 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
 
             keyFieldInfo = procedure->indexRepository->getRelationHelper()->getField(status, att, tra, sqlDialect, ftsIndex.relationName, keyFieldName);
 
-            if (fields.size() == 1) {
-                QueryParserPtr parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, fields[0], analyzer);
-                query = parser->parse(StringUtils::toUnicode(queryStr));
+            query = parseSearchQuery(ftsIndex, analyzer, queryStr);
+            if (searcher) {
+                // the shard readers are left open, they belong to the searchers
+                checkQueryExpansions(status, sharded ? newLucene<MultiReader>(shardReaders, false) : shardReaders[0], query, limits.maxExpansions);
+            }
+
+            bool timedOut = false;
+            // collectors need room for at least one hit, even over an empty index
+            const int32_t numHits = searcher ? std::max(1, std::min(limit, searcher->maxDoc())) : 0;
+            if (!searcher) {
+                // the partition has no documents
+                docs = newLucene<TopDocs>(0, Collection<ScoreDocPtr>::newInstance());
+            }
+            else if (recentFirst) {
+                docs = searchRecentFirst(searcher, partitionSearchers, query, sort, numHits, limits.timeout, timedOut);
+            }
+            else if (sharded && limits.timeout > 0) {
+                // ParallelMultiSearcher would feed a time limiting collector by the shards one by one
+                docs = searchShardsWithTimeout(searcher, shardSearchers, query, sort, numHits, limits.timeout, timedOut);
+            }
+            else if (sharded) {
+                if (sort) {
+                    docs = searcher->search(query, FilterPtr(), numHits, sort);
+                }
+                else {
+                    docs = searcher->search(query, FilterPtr(), numHits);
+                }
             }
             else {
-                MultiFieldQueryParserPtr  parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, fields, analyzer);
-                parser->setDefaultOperator(QueryParser::OR_OPERATOR);
-                query = parser->parse(StringUtils::toUnicode(queryStr));
+                TopDocsCollectorPtr topDocsCollector;
+                if (sort) {
+                    // The top N documents are selected by TopFieldCollector, which only keeps documents 
+                    // competitive with the current bottom of its queue. Scores are still tracked for FTS$SCORE.
+                    topDocsCollector = TopFieldCollector::create(sort, numHits, true, true, false, true);
+                }
+                else {
+                    topDocsCollector = TopScoreDocCollector::create(numHits, true);
+                }
+
+                if (limits.timeout > 0) {
+                    // Once the time is exceeded, collection stops and the hits collected so far are returned.
+                    auto timeLimitingCollector = newLucene<TimeLimitingCollector>(topDocsCollector, limits.timeout);
+                    try {
+                        searcher->search(query, timeLimitingCollector);
+                    }
+                    catch (const TimeExceededException&) {
+                        timedOut = true;
+                    }
+                }
+                else {
+                    searcher->search(query, topDocsCollector);
+                }
+                docs = topDocsCollector->topDocs();
             }
-            docs = searcher->search(query, limit);
 
             it = docs->scoreDocs.begin();
 
@@ -240,6 +885,12 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
             out->uuidNull = true;
             out->idNull = true;
             out->scoreNull = true;
+
+            out->totalHitsNull = false;
+            out->totalHits = docs->totalHits;
+
+            out->timedOutNull = false;
+            out->timedOut = timedOut;
         }
         catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
@@ -266,32 +917,7 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
             ScoreDocPtr scoreDoc = *it;
             DocumentPtr doc = searcher->doc(scoreDoc->doc);
 
-            try {
-                const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
-                if (unicodeKeyFieldName == L"RDB$DB_KEY") {
-                    // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
-                    auto dbKey = hex_to_binary(keyValue);
-                    auto dbKeyPtr = reinterpret_cast<char*>(dbKey.data());
-                    out->dbKeyNull = false;
-                    out->dbKey.length = static_cast<ISC_USHORT>(dbKey.size());
-                    std::copy(dbKeyPtr, dbKeyPtr + out->dbKey.length, out->dbKey.str);
-                }
-                else if (keyFieldInfo.isBinary()) {
-                    // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
-                    auto uuid = hex_to_binary(keyValue);
-                    auto uuidPtr = reinterpret_cast<char*>(uuid.data());
-                    out->uuidNull = false;
-                    out->uuid.length = static_cast<ISC_USHORT>(uuid.size());
-                    std::copy(uuidPtr, uuidPtr + out->uuid.length, out->uuid.str);
-                }
-                else if (keyFieldInfo.isInt()) {
-                    out->idNull = false;
-                    out->id = std::stoll(keyValue);
-                }
-            }
-            catch (const std::invalid_argument& e) {
-                throwException(status, e.what());
-            }
+            setSearchResultKey(status, out, doc, unicodeKeyFieldName, keyFieldInfo);
 
             out->scoreNull = false;
             out->score = scoreDoc->score;
@@ -317,32 +943,48 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
 FB_UDR_END_PROCEDURE
 
 /***
-PROCEDURE FTS$ANALYZE (
-    FTS$TEXT BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
-    FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
+PROCEDURE FTS$SEARCH_MULTI (
+    FTS$INDEX_NAMES VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 1000
 )
 RETURNS (
-    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID BIGINT,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$TOTAL_HITS BIGINT
 )
-EXTERNAL NAME 'luceneudr!ftsAnalyze'
+EXTERNAL NAME 'luceneudr!ftsSearchMulti'
 ENGINE UDR;
 ***/
-FB_UDR_BEGIN_PROCEDURE(ftsAnalyze)
+FB_UDR_BEGIN_PROCEDURE(ftsSearchMulti)
     FB_UDR_MESSAGE(InMessage,
-        (FB_BLOB, text)
-        (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), indexNames)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTEGER, limit)
     );
 
     FB_UDR_MESSAGE(OutMessage,
-        (FB_INTL_VARCHAR(32765, CS_UTF8), term)
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), relationName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), keyFieldName)
+        (FB_INTL_VARCHAR(8, CS_BINARY), dbKey)
+        (FB_BIGINT, id)
+        (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
+        (FB_DOUBLE, score)
+        (FB_BIGINT, totalHits)
     );
 
     FB_UDR_CONSTRUCTOR
-        , analyzers(std::make_unique<AnalyzerRepository>(context->getMaster()))
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
     {
     }
 
-    std::unique_ptr<AnalyzerRepository> analyzers;
+    FTSIndexRepositoryPtr indexRepository{nullptr};
 
     void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
         char* name, unsigned nameSize)
@@ -354,34 +996,754 @@ FB_UDR_BEGIN_PROCEDURE(ftsAnalyze)
 
     FB_UDR_EXECUTE_PROCEDURE
     {
+        if (in->indexNamesNull) {
+            throwException(status, "Index names can not be NULL");
+        }
+        if (in->limitNull || in->limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than zero");
+        }
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto limit = static_cast<int32_t>(in->limit);
+
+        const auto ftsConfig = getFtsConfig(status, context);
+
         AutoRelease<IAttachment> att(context->getAttachment(status));
         AutoRelease<ITransaction> tra(context->getTransaction(status));
 
-        const unsigned int sqlDialect = getSqlDialect(status, att);
+        unsigned int sqlDialect = getSqlDialect(status, att);
 
-        std::string analyzerName = DEFAULT_ANALYZER_NAME;
-        if (!in->analyzerNameNull) {
-            analyzerName.assign(in->analyzerName.str, in->analyzerName.length);
+        std::vector<std::string> indexNames;
+        std::istringstream indexNamesStream(std::string(in->indexNames.str, in->indexNames.length));
+        std::string indexName;
+        while (std::getline(indexNamesStream, indexName, ',')) {
+            const auto first = indexName.find_first_not_of(" \t\r\n");
+            if (first == std::string::npos) {
+                continue;
+            }
+            const auto last = indexName.find_last_not_of(" \t\r\n");
+            indexName = indexName.substr(first, last - first + 1);
+            if (std::find(indexNames.begin(), indexNames.end(), indexName) == indexNames.end()) {
+                indexNames.push_back(indexName);
+            }
+        }
+        if (indexNames.empty()) {
+            throwException(status, "Index names can not be empty");
         }
 
-        if (!in->textNull) {
-            std::string text = readStringFromBlob(status, att, tra, &in->text);
-            try {
-                auto analyzer = procedure->analyzers->createAnalyzer(status, att, tra, sqlDialect, analyzerName);
-                auto stringReader = newLucene<StringReader>(StringUtils::toUnicode(text));
+        try {
+            const auto analyzers = procedure->indexRepository->getAnalyzerRepository();
+            auto searchables = Collection<SearchablePtr>::newInstance();
+            // Each index has its own fields and analyzer, so the query is parsed per index. 
+            // Coordination is disabled: a document only ever matches the clause of its own index.
+            auto multiQuery = newLucene<BooleanQuery>(true);
+
+            for (const auto& name : indexNames) {
+                auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, name, true);
+                auto ftsIndexDirs = openSearchDirectories(status, *ftsConfig, ftsIndex);
+
+                AnalyzerPtr analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+                multiQuery->add(parseSearchQuery(ftsIndex, analyzer, queryStr), BooleanClause::SHOULD);
+                // a sharded or partitioned index has a searcher per directory, all of them belong to its source
+                for (const auto& ftsIndexDir : ftsIndexDirs) {
+                    searchables.add(newLucene<IndexSearcher>(ftsIndexDir, true));
+                    searchableSources.push_back(sources.size());
+                }
 
-                tokenStream = analyzer->tokenStream(L"", stringReader);
-                termAttribute = tokenStream->addAttribute<TermAttribute>();
-                tokenStream->reset();
-            } catch (const LuceneException& e) {
-                const std::string error_message = StringUtils::toUTF8(e.getError());
-                throwException(status, error_message.c_str());
+                SearchSource source;
+                source.indexName = ftsIndex.indexName;
+                source.relationName = ftsIndex.relationName;
+                for (const auto& segment : ftsIndex.segments) {
+                    if (segment.isKey()) {
+                        source.keyFieldName = segment.fieldName();
+                        source.unicodeKeyFieldName = StringUtils::toUnicode(source.keyFieldName);
+                    }
+                }
+                source.keyFieldInfo = procedure->indexRepository->getRelationHelper()->getField(status, att, tra, sqlDialect, source.relationName, source.keyFieldName);
+                sources.push_back(std::move(source));
             }
+
+            // Term statistics are aggregated over all indexes, so the scores of hits from different indexes are comparable. 
+            // The sub-searchers are queried in parallel and their hits are merged into one ranked list.
+            searcher = newLucene<ParallelMultiSearcher>(searchables);
+            // the hit queue is allocated for the whole limit
+            docs = searcher->search(multiQuery, std::max(1, std::min(limit, searcher->maxDoc())));
+            it = docs->scoreDocs.begin();
+
+            out->totalHitsNull = false;
+            out->totalHits = docs->totalHits;
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
         }
     }
 
-    TokenStreamPtr tokenStream = nullptr;
-    TermAttributePtr termAttribute = nullptr;
+    struct SearchSource
+    {
+        std::string indexName;
+        std::string relationName;
+        std::string keyFieldName;
+        String unicodeKeyFieldName;
+        RelationFieldInfo keyFieldInfo;
+    };
+
+    std::vector<SearchSource> sources;
+    // source of each sub-searcher
+    std::vector<size_t> searchableSources;
+    MultiSearcherPtr searcher{ nullptr };
+    TopDocsPtr docs{ nullptr };
+    Collection<ScoreDocPtr>::iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        try {
+            if (it == docs->scoreDocs.end()) {
+                return false;
+            }
+            ScoreDocPtr scoreDoc = *it;
+            DocumentPtr doc = searcher->doc(scoreDoc->doc);
+            const auto& source = sources[searchableSources[searcher->subSearcher(scoreDoc->doc)]];
+
+            out->indexNameNull = false;
+            out->indexName.length = static_cast<ISC_USHORT>(source.indexName.length());
+            source.indexName.copy(out->indexName.str, out->indexName.length);
+
+            out->relationNameNull = false;
+            out->relationName.length = static_cast<ISC_USHORT>(source.relationName.length());
+            source.relationName.copy(out->relationName.str, out->relationName.length);
+
+            out->keyFieldNameNull = false;
+            out->keyFieldName.length = static_cast<ISC_USHORT>(source.keyFieldName.length());
+            source.keyFieldName.copy(out->keyFieldName.str, out->keyFieldName.length);
+
+            out->dbKeyNull = true;
+            out->uuidNull = true;
+            out->idNull = true;
+            setSearchResultKey(status, out, doc, source.unicodeKeyFieldName, source.keyFieldInfo);
+
+            out->scoreNull = false;
+            out->score = scoreDoc->score;
+
+            ++it;
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+FUNCTION FTS$SEARCH_COUNT (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8
+)
+RETURNS BIGINT
+EXTERNAL NAME 'luceneudr!ftsSearchCount'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_FUNCTION(ftsSearchCount)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_BIGINT, totalHits)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_FUNCTION
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto ftsConfig = getFtsConfig(status, context);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        try {
+            auto reader = openIndexReader(openSearchDirectories(status, *ftsConfig, ftsIndex));
+
+            const auto analyzers = indexRepository->getAnalyzerRepository();
+            AnalyzerPtr analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            auto searcher = newLucene<IndexSearcher>(reader);
+
+            QueryPtr query = parseSearchQuery(ftsIndex, analyzer, queryStr);
+            // only count matches: no scoring, no priority queue, no stored fields
+            auto collector = newLucene<HitCountCollector>();
+            searcher->search(query, collector);
+            searcher->close();
+            reader->close();
+
+            out->totalHitsNull = false;
+            out->totalHits = collector->getTotalHits();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+FB_UDR_END_FUNCTION
+
+/***
+PROCEDURE FTS$FACETS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$TOP_N INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$VALUE VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$COUNT BIGINT
+)
+EXTERNAL NAME 'luceneudr!ftsFacets'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsFacets)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_INTEGER, topN)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), value)
+        (FB_BIGINT, count)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        if (in->fieldNameNull) {
+            throwException(status, "Field name can not be NULL");
+        }
+        if (in->topNNull || in->topN <= 0) {
+            throwException(status, "FTS$TOP_N must be greater than zero");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        const std::string fieldName(in->fieldName.str, in->fieldName.length);
+        const auto topN = static_cast<size_t>(in->topN);
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto ftsConfig = getFtsConfig(status, context);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+        const auto& segment = getSortableSegment(status, ftsIndex, fieldName);
+        const auto fieldInfo = procedure->indexRepository->getRelationHelper()->getField(status, att, tra, sqlDialect, ftsIndex.relationName, segment.fieldName());
+        const auto sortType = getSortType(fieldInfo);
+
+        try {
+            // the string index of the field is loaded once per version of the index and reused with the shared reader
+            const auto indexDirectoryPath = ftsConfig->ftsDirectory / ftsIndex.indexName;
+            // resolved before the directories are opened, a swap in between makes the next call open the reader again
+            const auto generationPath = getIndexGenerationPath(indexDirectoryPath);
+            auto reader = openSharedIndexReader(indexDirectoryPath, generationPath, openSearchDirectories(status, *ftsConfig, ftsIndex));
+
+            const auto analyzers = procedure->indexRepository->getAnalyzerRepository();
+            AnalyzerPtr analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            auto searcher = newLucene<IndexSearcher>(reader);
+
+            QueryPtr query = parseSearchQuery(ftsIndex, analyzer, queryStr);
+            auto collector = newLucene<DocSetCollector>(reader->maxDoc());
+            searcher->search(query, collector);
+
+            // The companion sort field holds exactly one untokenized term per document, 
+            // so the ordinals of the string index are the distinct field values in term order.
+            auto stringIndex = FieldCache::DEFAULT()->getStringIndex(reader, getSortFieldName(StringUtils::toUnicode(segment.fieldName())));
+            std::vector<int64_t> counts(stringIndex->lookup.size(), 0);
+            const auto docs = collector->getDocs();
+            for (int32_t doc = docs->nextSetBit(0); doc >= 0; doc = docs->nextSetBit(doc + 1)) {
+                ++counts[stringIndex->order[doc]];
+            }
+            searcher->close();
+
+            // ordinal 0 is reserved for documents without a value
+            std::vector<int32_t> ordinals;
+            for (size_t ord = 1; ord < counts.size(); ++ord) {
+                if (counts[ord] > 0) {
+                    ordinals.push_back(static_cast<int32_t>(ord));
+                }
+            }
+            const auto topEnd = ordinals.begin() + std::min(topN, ordinals.size());
+            std::partial_sort(ordinals.begin(), topEnd, ordinals.end(), [&counts](int32_t a, int32_t b) {
+                return counts[a] > counts[b] || (counts[a] == counts[b] && a < b);
+            });
+
+            facets.reserve(topEnd - ordinals.begin());
+            for (auto ordIt = ordinals.begin(); ordIt != topEnd; ++ordIt) {
+                facets.emplace_back(sortTermToString(sortType, stringIndex->lookup[*ordIt]), counts[*ordIt]);
+            }
+            it = facets.cbegin();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    std::vector<std::pair<std::string, int64_t>> facets;
+    std::vector<std::pair<std::string, int64_t>>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == facets.cend()) {
+            return false;
+        }
+        const auto& [value, count] = *it;
+        if (getCharLength(value) > 8191) {
+            throwException(status, "Facet value size exceeds 8191 characters");
+        }
+        out->valueNull = false;
+        out->value.length = static_cast<ISC_USHORT>(value.length());
+        value.copy(out->value.str, out->value.length);
+        out->countNull = false;
+        out->count = count;
+        ++it;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SUGGEST (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$PREFIX VARCHAR(255) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$DOC_FREQ INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsSuggest'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsSuggest)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_INTL_VARCHAR(1020, CS_UTF8), prefix)
+        (FB_INTEGER, limit)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(8191 * 4, CS_UTF8), term)
+        (FB_INTEGER, docFreq)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        if (in->fieldNameNull) {
+            throwException(status, "Field name can not be NULL");
+        }
+        if (in->limitNull || in->limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than zero");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        const std::string fieldName(in->fieldName.str, in->fieldName.length);
+        const auto limit = static_cast<size_t>(in->limit);
+
+        std::string prefix;
+        if (!in->prefixNull) {
+            prefix.assign(in->prefix.str, in->prefix.length);
+        }
+
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+        const auto segmentIt = findIndexSegment(ftsIndex, fieldName);
+        if (segmentIt == ftsIndex.segments.end() || segmentIt->isKey()) {
+            throwException(status, R"(Field "%s" is not an indexed field of index "%s".)", fieldName.c_str(), ftsIndex.indexName.c_str());
+        }
+
+        try {
+            auto ftsIndexDirs = openSearchDirectories(status, *ftsConfig, ftsIndex);
+            const auto indexDirectoryPath = ftsDirectoryPath / ftsIndex.indexName;
+            // the term dictionary is reused by every keystroke until the index changes
+            auto suggester = getTermSuggester(indexDirectoryPath.u8string(), ftsIndexDirs, StringUtils::toUnicode(segmentIt->fieldName()));
+            // the analyzers of the library produce terms in lower case
+            const auto lowerPrefix = StringUtils::toUTF8(StringUtils::toLower(StringUtils::toUnicode(prefix)));
+            suggestions = suggester->suggest(lowerPrefix, limit);
+            it = suggestions.cbegin();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    std::vector<TermSuggestion> suggestions;
+    std::vector<TermSuggestion>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == suggestions.cend()) {
+            return false;
+        }
+        if (getCharLength(it->term) > 8191) {
+            throwException(status, "Term size exceeds 8191 characters");
+        }
+        out->termNull = false;
+        out->term.length = static_cast<ISC_USHORT>(it->term.length());
+        it->term.copy(out->term.str, out->term.length);
+        out->docFreqNull = false;
+        out->docFreq = it->docFreq;
+        ++it;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$DID_YOU_MEAN (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 5
+)
+RETURNS (
+    FTS$SUGGESTED_QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$DOC_FREQ INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsDidYouMean'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsDidYouMean)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTEGER, limit)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), suggestedQuery)
+        (FB_INTEGER, docFreq)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        if (in->limitNull || in->limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than zero");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        const auto limit = static_cast<size_t>(in->limit);
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+        it = corrections.cend();
+        if (queryStr.empty()) {
+            return;
+        }
+
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        const auto analyzers = procedure->indexRepository->getAnalyzerRepository();
+        // the spellchecker index holds the terms, for other analyzers they are not words
+        if (!analyzers->isWordPreserving(status, att, tra, sqlDialect, ftsIndex.analyzer)) {
+            throwException(status, R"(Analyzer "%s" of index "%s" stems or splits words, spelling correction is not supported.)",
+                ftsIndex.analyzer.c_str(), ftsIndex.indexName.c_str());
+        }
+
+        // the spellchecker index is only written by rebuilding, optimizing and updating the index
+        const auto indexDirectoryPath = ftsDirectoryPath / ftsIndex.indexName;
+        const auto spellDirectoryPath = getSpellDirectoryPath(indexDirectoryPath);
+        if (!isSpellIndexEnabled(status, *ftsConfig, ftsIndex.indexName)) {
+            throwException(status, R"(Spellchecker index of index "%s" is not enabled, set the option spellIndex.)", ftsIndex.indexName.c_str());
+        }
+        if (!fs::is_directory(spellDirectoryPath)) {
+            throwException(status, R"(Spellchecker index of index "%s" is not built, rebuild the index.)", ftsIndex.indexName.c_str());
+        }
+
+        try {
+            auto reader = openIndexReader(openSearchDirectories(status, *ftsConfig, ftsIndex));
+            SpellChecker spellChecker(spellDirectoryPath, reader, getSpellFields(ftsIndex));
+
+            AnalyzerPtr analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+
+            // Words of the query that are not in the index, with their corrections. 
+            // The query is split by the index analyzer, so words are compared with the terms as they were indexed.
+            struct Misspelling
+            {
+                int32_t startOffset;
+                int32_t endOffset;
+                std::vector<SpellSuggestion> suggestions;
+            };
+            std::vector<Misspelling> misspellings;
+
+            const String unicodeQuery = StringUtils::toUnicode(queryStr);
+            auto tokenStream = analyzer->tokenStream(L"", newLucene<StringReader>(unicodeQuery));
+            auto termAttribute = tokenStream->addAttribute<TermAttribute>();
+            auto offsetAttribute = tokenStream->addAttribute<OffsetAttribute>();
+            tokenStream->reset();
+            while (tokenStream->incrementToken()) {
+                const auto endOffset = offsetAttribute->endOffset();
+                // field names of the query syntax are not words
+                if (static_cast<size_t>(endOffset) < unicodeQuery.length() && unicodeQuery[endOffset] == L':') {
+                    continue;
+                }
+                const String word = termAttribute->term();
+                if (spellChecker.wordFreq(word) > 0) {
+                    continue;
+                }
+                auto suggestions = spellChecker.suggestSimilar(word, limit);
+                if (!suggestions.empty()) {
+                    misspellings.push_back({ offsetAttribute->startOffset(), endOffset, std::move(suggestions) });
+                }
+            }
+            tokenStream->close();
+            reader->close();
+
+            if (misspellings.empty()) {
+                return;
+            }
+
+            // Beam search over the combinations of corrections, a combination is as frequent as its rarest word.
+            struct Combination
+            {
+                std::vector<size_t> choices;
+                int32_t docFreq;
+                double similarity;
+            };
+            std::vector<Combination> beam{ { {}, std::numeric_limits<int32_t>::max(), 0.0 } };
+            for (const auto& misspelling : misspellings) {
+                std::vector<Combination> extended;
+                for (const auto& combination : beam) {
+                    for (size_t i = 0; i < misspelling.suggestions.size(); ++i) {
+                        const auto& suggestion = misspelling.suggestions[i];
+                        Combination next = combination;
+                        next.choices.push_back(i);
+                        next.docFreq = std::min(next.docFreq, suggestion.docFreq);
+                        next.similarity += suggestion.similarity;
+                        extended.push_back(std::move(next));
+                    }
+                }
+                std::sort(extended.begin(), extended.end(), [](const Combination& a, const Combination& b) {
+                    return a.docFreq > b.docFreq || (a.docFreq == b.docFreq && a.similarity > b.similarity);
+                });
+                if (extended.size() > limit) {
+                    extended.resize(limit);
+                }
+                beam = std::move(extended);
+            }
+
+            corrections.reserve(beam.size());
+            for (const auto& combination : beam) {
+                String suggestedQuery = unicodeQuery;
+                // replace from the end so that the offsets of the preceding words stay valid
+                for (size_t i = misspellings.size(); i-- > 0; ) {
+                    const auto& misspelling = misspellings[i];
+                    suggestedQuery.replace(
+                        misspelling.startOffset, 
+                        misspelling.endOffset - misspelling.startOffset, 
+                        misspelling.suggestions[combination.choices[i]].word);
+                }
+                corrections.emplace_back(StringUtils::toUTF8(suggestedQuery), combination.docFreq);
+            }
+            it = corrections.cbegin();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    std::vector<std::pair<std::string, int32_t>> corrections;
+    std::vector<std::pair<std::string, int32_t>>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == corrections.cend()) {
+            return false;
+        }
+        const auto& [suggestedQuery, docFreq] = *it;
+        if (getCharLength(suggestedQuery) > 8191) {
+            throwException(status, "Suggested query size exceeds 8191 characters");
+        }
+        out->suggestedQueryNull = false;
+        out->suggestedQuery.length = static_cast<ISC_USHORT>(suggestedQuery.length());
+        suggestedQuery.copy(out->suggestedQuery.str, out->suggestedQuery.length);
+        out->docFreqNull = false;
+        out->docFreq = docFreq;
+        ++it;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$ANALYZE (
+    FTS$TEXT BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
+)
+RETURNS (
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8
+)
+EXTERNAL NAME 'luceneudr!ftsAnalyze'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsAnalyze)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_BLOB, text)
+        (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), term)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , analyzers(std::make_unique<AnalyzerRepository>(context->getMaster()))
+    {
+    }
+
+    std::unique_ptr<AnalyzerRepository> analyzers;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        std::string analyzerName = DEFAULT_ANALYZER_NAME;
+        if (!in->analyzerNameNull) {
+            analyzerName.assign(in->analyzerName.str, in->analyzerName.length);
+        }
+
+        if (!in->textNull) {
+            std::string text = readStringFromBlob(status, att, tra, &in->text);
+            try {
+                auto analyzer = procedure->analyzers->createAnalyzer(status, att, tra, sqlDialect, analyzerName);
+                auto stringReader = newLucene<StringReader>(StringUtils::toUnicode(text));
+
+                tokenStream = analyzer->tokenStream(L"", stringReader);
+                termAttribute = tokenStream->addAttribute<TermAttribute>();
+                tokenStream->reset();
+            } catch (const LuceneException& e) {
+                const std::string error_message = StringUtils::toUTF8(e.getError());
+                throwException(status, error_message.c_str());
+            }
+        }
+    }
+
+    TokenStreamPtr tokenStream = nullptr;
+    TermAttributePtr termAttribute = nullptr;
 
     FB_UDR_FETCH_PROCEDURE
     {
@@ -405,6 +1767,172 @@ FB_UDR_BEGIN_PROCEDURE(ftsAnalyze)
 
 FB_UDR_END_PROCEDURE
 
+/***
+PROCEDURE FTS$ANALYZE_BATCH (
+    FTS$SQL      BLOB SUB_TYPE TEXT CHARACTER SET UTF8 NOT NULL,
+    FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
+)
+RETURNS (
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$TF BIGINT,
+    FTS$DF BIGINT
+)
+EXTERNAL NAME 'luceneudr!ftsAnalyzeBatch'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsAnalyzeBatch)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_BLOB, sql)
+        (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), term)
+        (FB_BIGINT, tf)
+        (FB_BIGINT, df)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , analyzers(std::make_unique<AnalyzerRepository>(context->getMaster()))
+    {
+    }
+
+    std::unique_ptr<AnalyzerRepository> analyzers;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->sqlNull) {
+            throwException(status, "SQL query can not be NULL");
+        }
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        std::string analyzerName = DEFAULT_ANALYZER_NAME;
+        if (!in->analyzerNameNull) {
+            analyzerName.assign(in->analyzerName.str, in->analyzerName.length);
+        }
+
+        const std::string sql = readStringFromBlob(status, att, tra, &in->sql);
+
+        AutoRelease<IStatement> stmt(att->prepare(
+            status,
+            tra,
+            0,
+            sql.c_str(),
+            sqlDialect,
+            IStatement::PREPARE_PREFETCH_METADATA
+        ));
+        if (stmt->getType(status) != isc_info_sql_stmt_select) {
+            throwException(status, "The FTS$SQL parameter must contain a SELECT statement");
+        }
+
+        AutoRelease<IMessageMetadata> outputMetadata(stmt->getOutputMetadata(status));
+        // make all fields of string type except BLOB
+        AutoRelease<IMessageMetadata> textMetadata(prepareTextMetaData(status, outputMetadata));
+        const auto fields = makeFbFieldsInfo(status, textMetadata);
+        std::vector<unsigned char> buffer(textMetadata->getMessageLength(status));
+
+        try {
+            auto analyzer = procedure->analyzers->createAnalyzer(status, att, tra, sqlDialect, analyzerName);
+
+            AutoRelease<IResultSet> rs(stmt->openCursor(
+                status,
+                tra,
+                nullptr,
+                nullptr,
+                textMetadata,
+                0
+            ));
+
+            // Each record is a separate document: all its columns are analyzed,
+            // term frequencies are summed and document frequency is counted once per record.
+            int64_t docNo = 0;
+            while (rs->fetchNext(status, buffer.data()) == IStatus::RESULT_OK) {
+                ++docNo;
+                for (const auto& field : fields) {
+                    if (field.isNull(buffer.data())) {
+                        continue;
+                    }
+                    const std::string value = field.getStringValue(status, att, tra, buffer.data());
+                    if (value.empty()) {
+                        continue;
+                    }
+                    auto stringReader = newLucene<StringReader>(StringUtils::toUnicode(value));
+                    auto tokenStream = analyzer->reusableTokenStream(L"", stringReader);
+                    auto termAttribute = tokenStream->addAttribute<TermAttribute>();
+                    tokenStream->reset();
+                    while (tokenStream->incrementToken()) {
+                        auto& stat = termStats[termAttribute->term()];
+                        ++stat.tf;
+                        if (stat.lastDocNo != docNo) {
+                            stat.lastDocNo = docNo;
+                            ++stat.df;
+                        }
+                    }
+                    tokenStream->end();
+                }
+            }
+            rs->close(status);
+            rs.release();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+
+        it = termStats.cbegin();
+    }
+
+    struct TermStat
+    {
+        int64_t tf = 0;
+        int64_t df = 0;
+        int64_t lastDocNo = 0;
+    };
+
+    std::unordered_map<String, TermStat> termStats;
+    std::unordered_map<String, TermStat>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == termStats.cend()) {
+            return false;
+        }
+        const auto& [uTerm, stat] = *it;
+
+        if (uTerm.length() > 8191) {
+            throwException(status, "Term size exceeds 8191 characters");
+        }
+
+        const std::string term = StringUtils::toUTF8(uTerm);
+
+        out->termNull = false;
+        out->term.length = static_cast<ISC_USHORT>(term.length());
+        term.copy(out->term.str, out->term.length);
+
+        out->tfNull = false;
+        out->tf = stat.tf;
+
+        out->dfNull = false;
+        out->df = stat.df;
+
+        ++it;
+        return true;
+    }
+
+FB_UDR_END_PROCEDURE
+
 
 /***
 PROCEDURE FTS$UPDATE_INDEXES 
@@ -457,7 +1985,7 @@ FROM FTS$LOG
 ORDER BY FTS$LOG_ID
 )SQL";
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
         
         // fill map indexes of relationName
         std::unordered_map<std::string, std::list<FTSPreparedIndex>> indexesByRelation;
@@ -465,8 +1993,21 @@ ORDER BY FTS$LOG_ID
             // get all indexes with segments
             auto indexes = procedure->indexRepository->allIndexes(status, att, tra, sqlDialect, true);
 
+            // The changes of a relation with an index being rebuilt stay in the log 
+            // until the rebuilt index is swapped in, and are then applied to all its indexes. 
+            // The rebuild may not have read them, they would be lost if applied to the replaced index.
+            // A rebuild holds the lock of its shadow directory, a chunked rebuild is also marked until it is resumed.
+            std::unordered_set<std::string> heldRelations;
+            for (const auto& ftsIndex : indexes) {
+                if (ftsIndex.isRebuilding() || 
+                    isIndexDirectoryLocked(getShadowIndexDirectoryPath(ftsConfig->ftsDirectory / ftsIndex.indexName))) 
+                {
+                    heldRelations.insert(ftsIndex.relationName);
+                }
+            }
+
             for (auto&& ftsIndex : indexes) {
-                if (!ftsIndex.isActive()) {
+                if (!ftsIndex.isActive() || heldRelations.count(ftsIndex.relationName) > 0) {
                     continue;
                 }
                 const std::string indexName = ftsIndex.indexName;
@@ -480,7 +2021,7 @@ ORDER BY FTS$LOG_ID
                         tra,
                         sqlDialect,
                         std::move(ftsIndex),
-                        ftsDirectoryPath,
+                        ftsConfig,
                         true);
                     list.push_back(std::move(preparedIndex));
                 } catch (const FbException&) {
@@ -1,8 +1,15 @@
 #include "FTSHelper.h"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
 #include "Analyzers.h"
 #include "FBUtils.h"
 #include "FTSUtils.h"
+#include "IndexDirectory.h"
+#include "ReverseFieldAnalyzer.h"
+#include "SpellIndex.h"
 
 
 
@@ -11,6 +18,31 @@ namespace LuceneUDR
     using namespace Firebird;
     using namespace Lucene;
 
+    namespace {
+
+        FieldablePtr makeSortField(const FTSMetadata::FbFieldInfo& field, const std::string& value, const String& unicodeValue)
+        {
+            const String sortFieldName = getSortFieldName(field.ftsFieldName);
+            switch (field.ftsSortType) {
+            case FTSMetadata::FTSSortType::LONG:
+            {
+                // only the full precision term is needed for sorting
+                auto numericField = newLucene<NumericField>(sortFieldName, std::numeric_limits<int32_t>::max(), Field::STORE_NO, true);
+                numericField->setLongValue(std::stoll(value));
+                return numericField;
+            }
+            case FTSMetadata::FTSSortType::DOUBLE:
+            {
+                auto numericField = newLucene<NumericField>(sortFieldName, std::numeric_limits<int32_t>::max(), Field::STORE_NO, true);
+                numericField->setDoubleValue(std::stod(value));
+                return numericField;
+            }
+            default:
+                return newLucene<Field>(sortFieldName, unicodeValue, Field::STORE_NO, Field::INDEX_NOT_ANALYZED_NO_NORMS);
+            }
+        }
+    }
+
     FTSPreparedIndex prepareFtsIndex(
         Firebird::ThrowStatusWrapper* status,
         Firebird::IMaster* master,
@@ -18,10 +50,11 @@ namespace LuceneUDR
         Firebird::ITransaction* tra,
         unsigned int sqlDialect,
         FTSMetadata::FTSIndex&& ftsIndex,
-        const std::filesystem::path& ftsDirectoryPath,
-        bool whereKey)
+        const FtsConfigPtr& ftsConfig,
+        bool whereKey,
+        const std::filesystem::path& shadowDirectoryPath)
     {
-        return FTSPreparedIndex(status, master, att, tra, sqlDialect, std::move(ftsIndex), ftsDirectoryPath, whereKey);
+        return FTSPreparedIndex(status, master, att, tra, sqlDialect, std::move(ftsIndex), ftsConfig, whereKey, shadowDirectoryPath);
     }
 
     FTSPreparedIndex::FTSPreparedIndex(
@@ -31,19 +64,29 @@ namespace LuceneUDR
         ITransaction* tra,
         unsigned int sqlDialect,
         FTSMetadata::FTSIndex&& ftsIndex,
-        const std::filesystem::path& ftsDirectoryPath,
-        bool whereKey
+        const FtsConfigPtr& ftsConfig,
+        bool whereKey,
+        const std::filesystem::path& shadowDirectoryPath
     )
         : m_master(master)
         , m_ftsIndex(std::move(ftsIndex))
+        , m_ftsConfig(ftsConfig)
         , m_fields()
         , m_params()
-        , m_indexDirectoryPath(ftsDirectoryPath / m_ftsIndex.indexName)
+        , m_indexDirectoryPath(shadowDirectoryPath.empty() ? getIndexGenerationPath(ftsConfig->ftsDirectory / m_ftsIndex.indexName) : shadowDirectoryPath)
+        , m_shadow(!shadowDirectoryPath.empty())
         , m_stmtExtractRecord{ nullptr }
         , m_inMetaExtractRecord{ nullptr }
         , m_outMetaExtractRecord{ nullptr }
+        , m_stmtExtractFirstChunk{ nullptr }
+        , m_stmtExtractNextChunk{ nullptr }
         , m_outputBuffer()
-        , m_indexWriter()
+        , m_partitioned(false)
+        , m_partitionFieldIndex(0)
+        , m_writerAnalyzer()
+        , m_partitionShardPaths()
+        , m_indexWriters()
+        , m_shadowLock()
         , m_unicodeKeyFieldName()
     {
         // check segments exists
@@ -151,11 +194,49 @@ namespace LuceneUDR
             field.ftsKey = segment.isKey();
             field.ftsBoost = segment.boost();
             field.ftsBoostNull = segment.isBoostNull();
+            if (segment.isSortable()) {
+                field.ftsSortType = FTSMetadata::sortTypeFromSqlType(
+                    outputMetadata->getType(status, field.fieldIndex),
+                    outputMetadata->getScale(status, field.fieldIndex)
+                );
+            }
+            field.ftsReversed = segment.isReversed() && !segment.isKey();
+            field.ftsOmitNorms = segment.isOmitNorms();
+            field.ftsOmitPositions = segment.isOmitPositions();
+            field.ftsTermVectors = segment.hasTermVectors();
+            field.ftsNotAnalyzed = segment.isNotAnalyzed();
             if (field.ftsKey) {
                 m_unicodeKeyFieldName = field.ftsFieldName;
             }
         }
 
+        // the layout on disk changes only by the rebuild
+        m_partitioned = m_ftsIndex.isPartitioned();
+        const auto builtPartitioning = getIndexPartitioning(m_indexDirectoryPath);
+        if (isIndexPartitioned(m_indexDirectoryPath, m_partitioned) != m_partitioned ||
+            (m_partitioned && builtPartitioning && *builtPartitioning != m_ftsIndex.partitioning())) 
+        {
+            auto iscStatus = IscRandomStatus::createFmtStatus(
+                R"(Invalid FTS index "%s". The partitioning of the index has changed, it must be rebuilt.)",
+                m_ftsIndex.indexName.c_str()
+            );
+            throw FbException(status, iscStatus);
+        }
+        if (m_partitioned) {
+            const auto partitionFieldIt = std::find_if(m_fields.cbegin(), m_fields.cend(), [this](const auto& field) {
+                return field.fieldName == m_ftsIndex.partitionField;
+            });
+            if (partitionFieldIt == m_fields.cend()) {
+                auto iscStatus = IscRandomStatus::createFmtStatus(
+                    R"(Invalid FTS index "%s". Partition field "%s" is not a field of the index.)",
+                    m_ftsIndex.indexName.c_str(),
+                    m_ftsIndex.partitionField.c_str()
+                );
+                throw FbException(status, iscStatus);
+            }
+            m_partitionFieldIndex = static_cast<size_t>(partitionFieldIt - m_fields.cbegin());
+        }
+
         // Check if the index directory exists, and if it doesn't exist, create it.
         if (!LuceneUDR::createIndexDirectory(m_indexDirectoryPath)) {
             auto iscStatus = IscRandomStatus::createFmtStatus(
@@ -165,14 +246,37 @@ namespace LuceneUDR
             throw FbException(status, iscStatus);
         }
 
-        FTSMetadata::AnalyzerRepository analyzerRepository(master);
-        auto wIndexDirectoryPath = m_indexDirectoryPath.wstring();
+        // The lock marks the rebuild from its start, so that FTS$UPDATE_INDEXES keeps the changes of the relation in the log. 
+        // Writers of an index that is not partitioned lock their directories below.
+        if (m_shadow && m_partitioned) {
+            try {
+                m_shadowLock = FSDirectory::open(m_indexDirectoryPath.wstring())->makeLock(IndexWriter::WRITE_LOCK_NAME);
+                if (!m_shadowLock->obtain()) {
+                    m_shadowLock.reset();
+                    auto iscStatus = IscRandomStatus::createFmtStatus(
+                        R"(Index "%s" is already being rebuilt.)",
+                        m_ftsIndex.indexName.c_str()
+                    );
+                    throw FbException(status, iscStatus);
+                }
+            } catch (const LuceneException& e) {
+                const std::string error_message = StringUtils::toUTF8(e.getError());
+                auto iscStatus = IscRandomStatus(error_message);
+                throw FbException(status, iscStatus);
+            }
+        }
 
+        FTSMetadata::AnalyzerRepository analyzerRepository(master);
         try {
-            auto fsIndexDir = FSDirectory::open(wIndexDirectoryPath);
-            bool created = fsIndexDir->listAll().empty();
             auto analyzer = analyzerRepository.createAnalyzer(status, att, tra, sqlDialect, m_ftsIndex.analyzer);
-            m_indexWriter = newLucene<IndexWriter>(fsIndexDir, analyzer, created, IndexWriter::MaxFieldLengthUNLIMITED);
+            // companion fields of reversed segments are analyzed as their segments, then reversed
+            m_writerAnalyzer = newLucene<ReverseFieldAnalyzer>(analyzer, REVERSE_FIELD_SUFFIX);
+            // the writers of partitions are opened when their documents are written
+            if (!m_partitioned) {
+                for (const auto& shardDirectoryPath : getPartitionShardPaths(status, m_indexDirectoryPath)) {
+                    getIndexWriter(status, shardDirectoryPath);
+                }
+            }
         } catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
             auto iscStatus = IscRandomStatus(error_message);
@@ -183,7 +287,14 @@ namespace LuceneUDR
     void FTSPreparedIndex::deleteAll(Firebird::ThrowStatusWrapper* status)
     try
     {
-        m_indexWriter->deleteAll();
+        for (const auto& partitionPath : getIndexPartitionPaths(m_indexDirectoryPath)) {
+            for (const auto& shardDirectoryPath : getPartitionShardPaths(status, partitionPath)) {
+                getIndexWriter(status, shardDirectoryPath);
+            }
+        }
+        for (const auto& [shardDirectoryPath, indexWriter] : m_indexWriters) {
+            indexWriter->deleteAll();
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
@@ -192,7 +303,10 @@ namespace LuceneUDR
 
     void FTSPreparedIndex::optimize(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->optimize();
+        // only the partitions changed by this writing are merged
+        for (const auto& [shardDirectoryPath, indexWriter] : m_indexWriters) {
+            indexWriter->optimize();
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
@@ -201,7 +315,13 @@ namespace LuceneUDR
 
     void FTSPreparedIndex::rollback(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->rollback();
+        for (const auto& [shardDirectoryPath, indexWriter] : m_indexWriters) {
+            indexWriter->rollback();
+        }
+        if (m_shadowLock) {
+            m_shadowLock->release();
+            m_shadowLock.reset();
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
@@ -210,7 +330,20 @@ namespace LuceneUDR
 
     void FTSPreparedIndex::commit(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->commit();
+        for (const auto& [shardDirectoryPath, indexWriter] : m_indexWriters) {
+            indexWriter->commit();
+            if (!m_shadow) {
+                commitIndexDirectory(status, *m_ftsConfig, m_ftsIndex.indexName, shardDirectoryPath);
+            }
+        }
+        // the spellchecker index takes the new words of the committed changes, 
+        // a rebuilt index gets a new spellchecker index when it is swapped in
+        if (!m_shadow && !m_indexWriters.empty() && isSpellIndexEnabled(status, *m_ftsConfig, m_ftsIndex.indexName)) {
+            updateSpellIndex(
+                m_ftsConfig->ftsDirectory / m_ftsIndex.indexName,
+                getAllIndexShardPaths(m_indexDirectoryPath, m_ftsIndex.shardCount, m_ftsIndex.isPartitioned()),
+                getSpellFields(m_ftsIndex));
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
@@ -219,7 +352,13 @@ namespace LuceneUDR
 
     void FTSPreparedIndex::close(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->close();
+        for (const auto& [shardDirectoryPath, indexWriter] : m_indexWriters) {
+            indexWriter->close();
+        }
+        if (m_shadowLock) {
+            m_shadowLock->release();
+            m_shadowLock.reset();
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
@@ -230,24 +369,187 @@ namespace LuceneUDR
         Firebird::ThrowStatusWrapper* status,
         Firebird::IAttachment* att,
         Firebird::ITransaction* tra)
+    {
+        return makeFtsDocument(status, att, tra, m_fields, m_outputBuffer.data(), m_ftsIndex.allField);
+    }
+
+    const std::vector<std::filesystem::path>& FTSPreparedIndex::getPartitionShardPaths(
+        Firebird::ThrowStatusWrapper* status,
+        const std::filesystem::path& partitionPath)
+    {
+        auto it = m_partitionShardPaths.find(partitionPath);
+        if (it != m_partitionShardPaths.end()) {
+            return it->second;
+        }
+        auto shardPaths = getIndexShardPaths(partitionPath, m_ftsIndex.shardCount);
+        for (const auto& shardDirectoryPath : shardPaths) {
+            if (!LuceneUDR::createIndexDirectory(shardDirectoryPath)) {
+                auto iscStatus = IscRandomStatus::createFmtStatus(
+                    R"(Cannot create index directory "%s".)",
+                    shardDirectoryPath.u8string().c_str()
+                );
+                throw FbException(status, iscStatus);
+            }
+        }
+        return m_partitionShardPaths.emplace(partitionPath, std::move(shardPaths)).first->second;
+    }
+
+    const Lucene::IndexWriterPtr& FTSPreparedIndex::getIndexWriter(
+        Firebird::ThrowStatusWrapper* status,
+        const std::filesystem::path& shardDirectoryPath)
+    {
+        auto it = m_indexWriters.find(shardDirectoryPath);
+        if (it != m_indexWriters.end()) {
+            return it->second;
+        }
+        // a resident index is loaded into memory from the swapped in directory
+        auto indexDir = m_shadow
+            ? FSDirectory::open(shardDirectoryPath.wstring())
+            : openIndexWriterDirectory(status, *m_ftsConfig, m_ftsIndex.indexName, shardDirectoryPath);
+        bool created = indexDir->listAll().empty();
+        auto indexWriter = newLucene<IndexWriter>(indexDir, m_writerAnalyzer, created, IndexWriter::MaxFieldLengthUNLIMITED);
+        return m_indexWriters.emplace(shardDirectoryPath, indexWriter).first->second;
+    }
+
+    const Lucene::IndexWriterPtr& FTSPreparedIndex::getShardWriter(
+        Firebird::ThrowStatusWrapper* status,
+        const std::filesystem::path& partitionPath,
+        const Lucene::String& keyValue)
+    {
+        const auto& shardPaths = getPartitionShardPaths(status, partitionPath);
+        const size_t shard = shardPaths.size() == 1 ? 0 : getIndexShard(keyValue, shardPaths.size());
+        return getIndexWriter(status, shardPaths[shard]);
+    }
+
+    std::filesystem::path FTSPreparedIndex::getPartitionPath(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra)
+    {
+        if (!m_partitioned) {
+            return m_indexDirectoryPath;
+        }
+        const std::string value = m_fields[m_partitionFieldIndex].getStringValue(status, att, tra, m_outputBuffer.data());
+        if (m_ftsIndex.isPartitionedByMonth()) {
+            return getIndexPartitionPath(m_indexDirectoryPath, getMonthPartitionValue(status, value));
+        }
+        return getIndexPartitionPath(m_indexDirectoryPath, value);
+    }
+
+    void FTSPreparedIndex::deleteDocument(
+        Firebird::ThrowStatusWrapper* status,
+        const Lucene::String& keyValue,
+        const std::filesystem::path& exceptPartitionPath)
+    {
+        TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, keyValue);
+        if (!m_partitioned) {
+            getShardWriter(status, m_indexDirectoryPath, keyValue)->deleteDocuments(term);
+            return;
+        }
+        // The deleted record is gone, so its partition is unknown and the key is deleted from every partition. 
+        // Partitions not written yet are only opened for writing if they hold the key, 
+        // so that cold partitions are not rewritten by deletes of other partitions.
+        for (const auto& partitionPath : getIndexPartitionPaths(m_indexDirectoryPath)) {
+            if (partitionPath == exceptPartitionPath) {
+                continue;
+            }
+            const auto& shardPaths = getPartitionShardPaths(status, partitionPath);
+            const auto& shardDirectoryPath = shardPaths[shardPaths.size() == 1 ? 0 : getIndexShard(keyValue, shardPaths.size())];
+            if (m_indexWriters.find(shardDirectoryPath) == m_indexWriters.end()) {
+                auto indexDir = openIndexDirectory(status, *m_ftsConfig, m_ftsIndex.indexName, shardDirectoryPath);
+                if (!IndexReader::indexExists(indexDir)) {
+                    continue;
+                }
+                auto reader = IndexReader::open(indexDir, true);
+                const bool hasKey = reader->docFreq(term) > 0;
+                reader->close();
+                if (!hasKey) {
+                    continue;
+                }
+            }
+            getIndexWriter(status, shardDirectoryPath)->deleteDocuments(term);
+        }
+    }
+
+    void FTSPreparedIndex::writeDocument(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra,
+        const Lucene::String& keyValue,
+        std::string_view changeType)
+    {
+        auto doc = makeDocument(status, att, tra);
+        const auto partitionPath = getPartitionPath(status, att, tra);
+
+        if ((changeType == "I") && doc) {
+            // the record may already be indexed by a rebuild that read it before the change was applied
+            TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, keyValue);
+            getShardWriter(status, partitionPath, keyValue)->updateDocument(term, doc);
+        }
+        if (changeType == "U") {
+            // the record could have moved from another partition
+            if (m_partitioned) {
+                deleteDocument(status, keyValue, partitionPath);
+            }
+            TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, keyValue);
+            if (doc) {
+                getShardWriter(status, partitionPath, keyValue)->updateDocument(term, doc);
+            } else {
+                getShardWriter(status, partitionPath, keyValue)->deleteDocuments(term);
+            }
+        }
+    }
+
+    Lucene::DocumentPtr makeFtsDocument(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra,
+        const FTSMetadata::FbFieldsInfo& fields,
+        unsigned char* buffer,
+        bool allField)
     {
         bool emptyFlag = true;
         auto doc = newLucene<Document>();
 
-        for (const auto& field : m_fields) {
-            const std::string value = field.getStringValue(status, att, tra, m_outputBuffer.data());
+        for (const auto& field : fields) {
+            const std::string value = field.getStringValue(status, att, tra, buffer);
             Lucene::String unicodeValue = StringUtils::toUnicode(value);
             // add field to document
             if (field.ftsKey) {
                 auto luceneField = newLucene<Field>(field.ftsFieldName, unicodeValue, Field::STORE_YES, Field::INDEX_NOT_ANALYZED);
                 doc->add(luceneField);
             } else {
-                auto luceneField = newLucene<Field>(field.ftsFieldName, unicodeValue, Field::STORE_NO, Field::INDEX_ANALYZED);
+                const auto index = field.ftsNotAnalyzed
+                    ? (field.ftsOmitNorms ? Field::INDEX_NOT_ANALYZED_NO_NORMS : Field::INDEX_NOT_ANALYZED)
+                    : (field.ftsOmitNorms ? Field::INDEX_ANALYZED_NO_NORMS : Field::INDEX_ANALYZED);
+                const auto termVector = field.ftsTermVectors ? Field::TERM_VECTOR_WITH_POSITIONS_OFFSETS : Field::TERM_VECTOR_NO;
+                auto luceneField = newLucene<Field>(field.ftsFieldName, unicodeValue, Field::STORE_NO, index, termVector);
+                if (field.ftsOmitPositions) {
+                    luceneField->setOmitTermFreqAndPositions(true);
+                }
                 if (!field.ftsBoostNull) {
                     luceneField->setBoost(field.ftsBoost);
                 }
                 doc->add(luceneField);
                 emptyFlag = emptyFlag && unicodeValue.empty();
+                // every content field adds its value to the catch-all field, 
+                // the values are separated by the position increment gap of the analyzer
+                if (allField && !unicodeValue.empty()) {
+                    doc->add(newLucene<Field>(ALL_FIELD_NAME, unicodeValue, Field::STORE_NO, Field::INDEX_ANALYZED));
+                }
+                // companion field for leading wildcard queries, does not affect relevance
+                if (field.ftsReversed && !unicodeValue.empty()) {
+                    doc->add(newLucene<Field>(getReverseFieldName(field.ftsFieldName), unicodeValue, Field::STORE_NO, Field::INDEX_ANALYZED_NO_NORMS));
+                }
+            }
+            // companion field for sorting, NULL values are not indexed
+            if (field.ftsSortType != FTSMetadata::FTSSortType::NONE && !field.isNull(buffer)) {
+                try {
+                    doc->add(makeSortField(field, value, unicodeValue));
+                }
+                catch (const std::logic_error& e) {
+                    throwException(status, R"(Invalid value "%s" of sortable field "%s": %s)", value.c_str(), field.fieldName.c_str(), e.what());
+                }
             }
         }
         if (emptyFlag) { 
@@ -274,13 +576,111 @@ namespace LuceneUDR
         while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
             auto doc = makeDocument(status, att, tra);
             if (doc) {
-                m_indexWriter->addDocument(doc);
+                getShardWriter(status, getPartitionPath(status, att, tra), doc->get(m_unicodeKeyFieldName))->addDocument(doc);
             }
         }
         rs->close(status);
         rs.release();
     }
 
+    unsigned int FTSPreparedIndex::rebuildChunk(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string& lastKey,
+        unsigned int chunkSize,
+        bool replace
+    )
+    {
+        const auto keyFieldIt = std::find_if(m_fields.cbegin(), m_fields.cend(), [](const auto& field) {
+            return field.ftsKey;
+        });
+        // records are not ordered by RDB$DB_KEY and can be moved by the garbage collection between the chunks
+        if (keyFieldIt == m_fields.cend() || keyFieldIt->fieldName == "DB_KEY" || keyFieldIt->fieldName == "RDB$DB_KEY") {
+            auto iscStatus = IscRandomStatus::createFmtStatus(
+                R"(Invalid FTS index "%s". A chunked rebuild requires an integer or UUID key field.)",
+                m_ftsIndex.indexName.c_str()
+            );
+            throw FbException(status, iscStatus);
+        }
+        const bool afterKey = !lastKey.empty();
+        auto& stmt = afterKey ? m_stmtExtractNextChunk : m_stmtExtractFirstChunk;
+        if (!stmt.hasData()) {
+            const std::string sql = m_ftsIndex.buildSqlSelectFieldValuesChunk(status, sqlDialect, afterKey, chunkSize);
+            stmt.reset(att->prepare(
+                status,
+                tra,
+                0,
+                sql.c_str(),
+                sqlDialect,
+                IStatement::PREPARE_PREFETCH_METADATA
+            ));
+        }
+
+        FB_MESSAGE(IDInput, ThrowStatusWrapper,
+            (FB_BIGINT, id)
+        ) idInput(status, m_master);
+
+        FB_MESSAGE(UUIDInput, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
+        ) uuidInput(status, m_master);
+
+        IMessageMetadata* inMetadata = nullptr;
+        unsigned char* inBuffer = nullptr;
+        if (afterKey) {
+            // the key is indexed as hex of a binary value or as the text of a number
+            if (keyFieldIt->isBinary()) {
+                const auto uuid = hex_to_binary(lastKey);
+                uuidInput->uuidNull = FB_FALSE;
+                uuidInput->uuid.length = static_cast<ISC_USHORT>(std::min<size_t>(uuid.size(), sizeof(uuidInput->uuid.str)));
+                memcpy(uuidInput->uuid.str, uuid.data(), uuidInput->uuid.length);
+                inMetadata = uuidInput.getMetadata();
+                inBuffer = uuidInput.getData();
+            }
+            else {
+                idInput->idNull = FB_FALSE;
+                try {
+                    idInput->id = std::stoll(lastKey);
+                }
+                catch (const std::logic_error&) {
+                    throwException(status, R"(Invalid FTS index "%s". A chunked rebuild requires an integer or UUID key field.)", m_ftsIndex.indexName.c_str());
+                }
+                inMetadata = idInput.getMetadata();
+                inBuffer = idInput.getData();
+            }
+        }
+
+        AutoRelease<IResultSet> rs(stmt->openCursor(
+            status,
+            tra,
+            inMetadata,
+            inBuffer,
+            m_outMetaExtractRecord,
+            0
+        ));
+
+        unsigned int count = 0;
+        while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
+            auto doc = makeDocument(status, att, tra);
+            if (doc) {
+                const String keyValue = doc->get(m_unicodeKeyFieldName);
+                const auto& indexWriter = getShardWriter(status, getPartitionPath(status, att, tra), keyValue);
+                if (replace) {
+                    indexWriter->updateDocument(newLucene<Term>(m_unicodeKeyFieldName, keyValue), doc);
+                }
+                else {
+                    indexWriter->addDocument(doc);
+                }
+            }
+            lastKey = keyFieldIt->getStringValue(status, att, tra, m_outputBuffer.data());
+            count++;
+        }
+        rs->close(status);
+        rs.release();
+        return count;
+    }
+
     void FTSPreparedIndex::updateIndexById(
         Firebird::ThrowStatusWrapper* status,
         Firebird::IAttachment* att,
@@ -293,8 +693,7 @@ namespace LuceneUDR
         Lucene::String unicodeKeyValue = StringUtils::toUnicode(sId);
 
         if (changeType == "D") {
-            TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-            m_indexWriter->deleteDocuments(term);
+            deleteDocument(status, unicodeKeyValue);
             return;
         }
 
@@ -317,19 +716,7 @@ namespace LuceneUDR
         );
 
         while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
-            auto doc = makeDocument(status, att, tra);
-
-            if ((changeType == "I") && doc) {
-                m_indexWriter->addDocument(doc);
-            }
-            if (changeType == "U") {
-                TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-                if (doc) {
-                    m_indexWriter->updateDocument(term, doc);
-                } else {
-                    m_indexWriter->deleteDocuments(term);
-                }
-            }
+            writeDocument(status, att, tra, unicodeKeyValue, changeType);
         }
         rs->close(status);
         rs.release();
@@ -347,8 +734,7 @@ namespace LuceneUDR
         Lucene::String unicodeKeyValue = StringUtils::toUnicode(sUuid);
 
         if (changeType == "D") {
-            TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-            m_indexWriter->deleteDocuments(term);
+            deleteDocument(status, unicodeKeyValue);
             return;
         }
 
@@ -370,19 +756,7 @@ namespace LuceneUDR
                 0));
 
         while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
-            auto doc = makeDocument(status, att, tra);
-
-            if ((changeType == "I") && doc) {
-                m_indexWriter->addDocument(doc);
-            }
-            if (changeType == "U") {
-                TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-                if (doc) {
-                    m_indexWriter->updateDocument(term, doc);
-                } else {
-                    m_indexWriter->deleteDocuments(term);
-                }
-            }
+            writeDocument(status, att, tra, unicodeKeyValue, changeType);
         }
         rs->close(status);
         rs.release();
@@ -400,8 +774,7 @@ namespace LuceneUDR
         Lucene::String unicodeKeyValue = StringUtils::toUnicode(sDbkey);
 
         if (changeType == "D") {
-            TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-            m_indexWriter->deleteDocuments(term);
+            deleteDocument(status, unicodeKeyValue);
             return;
         }
 
@@ -423,19 +796,7 @@ namespace LuceneUDR
                 0));
 
         while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
-            auto doc = makeDocument(status, att, tra);
-
-            if ((changeType == "I") && doc) {
-                m_indexWriter->addDocument(doc);
-            }
-            if (changeType == "U") {
-                TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-                if (doc) {
-                    m_indexWriter->updateDocument(term, doc);
-                } else {
-                    m_indexWriter->deleteDocuments(term);
-                }
-            }
+            writeDocument(status, att, tra, unicodeKeyValue, changeType);
         }
         rs->close(status);
         rs.release();
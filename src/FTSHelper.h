@@ -2,14 +2,36 @@
 #define FTS_HELPER_H
 
 #include <filesystem>
+#include <map>
+#include <vector>
 
 #include "FBFieldInfo.h"
 #include "FTSIndex.h"
+#include "FTSUtils.h"
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
 
 namespace LuceneUDR
 {
+    // Suffix of the companion field that holds the values of a sortable segment.
+    constexpr wchar_t SORT_FIELD_SUFFIX[] = L"#SORT";
+
+    inline Lucene::String getSortFieldName(const Lucene::String& fieldName)
+    {
+        return fieldName + SORT_FIELD_SUFFIX;
+    }
+
+    // Suffix of the companion field that holds the reversed terms of a segment.
+    constexpr wchar_t REVERSE_FIELD_SUFFIX[] = L"#REV";
+
+    inline Lucene::String getReverseFieldName(const Lucene::String& fieldName)
+    {
+        return fieldName + REVERSE_FIELD_SUFFIX;
+    }
+
+    // Name of the catch-all field that holds the terms of all content fields of the index.
+    constexpr wchar_t ALL_FIELD_NAME[] = L"_ALL";
+
     class FTSPreparedIndex final
     {
     public:
@@ -22,8 +44,9 @@ namespace LuceneUDR
             Firebird::ITransaction* tra,
             unsigned int sqlDialect,
             FTSMetadata::FTSIndex&& ftsIndex,
-            const std::filesystem::path& ftsDirectoryPath,
-            bool whereKey);
+            const FtsConfigPtr& ftsConfig,
+            bool whereKey,
+            const std::filesystem::path& shadowDirectoryPath = {});
 
         // non-copyable
         FTSPreparedIndex(const FTSPreparedIndex& rhs) = delete;
@@ -38,6 +61,31 @@ namespace LuceneUDR
             Firebird::ITransaction* tra
         );
 
+        /// <summary>
+        /// Adds the next chunk of records in the order of the key to the index. 
+        /// The chunks can be read in different transactions.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="lastKey">Key of the last record read as it is indexed, empty for the first chunk. Set to the key of the last record of the chunk</param>
+        /// <param name="chunkSize">Maximum number of records in the chunk</param>
+        /// <param name="replace">Documents replace those with the same key. 
+        /// A resumed rebuild can read again records committed to the index after its checkpoint</param>
+        /// 
+        /// <returns>Number of records read, less than chunkSize for the last chunk</returns>
+        unsigned int rebuildChunk(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string& lastKey,
+            unsigned int chunkSize,
+            bool replace = false
+        );
+
         void updateIndexById(
             Firebird::ThrowStatusWrapper* status,
             Firebird::IAttachment* att,
@@ -71,10 +119,6 @@ namespace LuceneUDR
         void close(Firebird::ThrowStatusWrapper* status);
 
 
-        Lucene::IndexWriterPtr getIndexWriter() { 
-            return m_indexWriter;
-        }
-
         FTSMetadata::FTSKeyType keyType() const
         {
             return m_ftsIndex.keyFieldType;
@@ -85,20 +129,98 @@ namespace LuceneUDR
             Firebird::IAttachment* att,
             Firebird::ITransaction* tra
         );
+
+        // shard directories of a partition, the index directory of an unpartitioned index
+        const std::vector<std::filesystem::path>& getPartitionShardPaths(
+            Firebird::ThrowStatusWrapper* status,
+            const std::filesystem::path& partitionPath
+        );
+
+        // writers are opened on first use and kept until the index is closed
+        const Lucene::IndexWriterPtr& getIndexWriter(
+            Firebird::ThrowStatusWrapper* status,
+            const std::filesystem::path& shardDirectoryPath
+        );
+
+        // writer of the shard holding the document with the given key value
+        const Lucene::IndexWriterPtr& getShardWriter(
+            Firebird::ThrowStatusWrapper* status,
+            const std::filesystem::path& partitionPath,
+            const Lucene::String& keyValue
+        );
+
+        // partition of the current record
+        std::filesystem::path getPartitionPath(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra
+        );
+
+        void deleteDocument(
+            Firebird::ThrowStatusWrapper* status,
+            const Lucene::String& keyValue,
+            const std::filesystem::path& exceptPartitionPath = {}
+        );
+
+        // applies the change of the current record to the index
+        void writeDocument(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            const Lucene::String& keyValue,
+            std::string_view changeType
+        );
     private:
         Firebird::IMaster* m_master { nullptr };
         FTSMetadata::FTSIndex m_ftsIndex;
+        FtsConfigPtr m_ftsConfig;
         FTSMetadata::FbFieldsInfo m_fields;
         FTSMetadata::FbFieldsInfo m_params;
         std::filesystem::path m_indexDirectoryPath;
+        // the index is rebuilt on disk in a shadow directory, to be swapped in when complete
+        bool m_shadow{ false };
         Firebird::AutoRelease<Firebird::IStatement> m_stmtExtractRecord;
         Firebird::AutoRelease<Firebird::IMessageMetadata> m_inMetaExtractRecord;
         Firebird::AutoRelease<Firebird::IMessageMetadata> m_outMetaExtractRecord;
+        // the first and the following chunks of a chunked rebuild, prepared on first use
+        Firebird::AutoRelease<Firebird::IStatement> m_stmtExtractFirstChunk;
+        Firebird::AutoRelease<Firebird::IStatement> m_stmtExtractNextChunk;
         std::vector<unsigned char> m_outputBuffer;
-        Lucene::IndexWriterPtr m_indexWriter;
+        bool m_partitioned{ false };
+        size_t m_partitionFieldIndex{ 0 };
+        Lucene::AnalyzerPtr m_writerAnalyzer;
+        std::map<std::filesystem::path, std::vector<std::filesystem::path>> m_partitionShardPaths;
+        std::map<std::filesystem::path, Lucene::IndexWriterPtr> m_indexWriters;
+        // lock of the shadow directory of a partitioned index, whose writers are opened on first use
+        Lucene::LockPtr m_shadowLock;
         Lucene::String m_unicodeKeyFieldName; 
     };
 
+    /// <summary>
+    /// Builds a Lucene document from a record of the index source query.
+    /// </summary>
+    /// 
+    /// <param name="status">Status</param>
+    /// <param name="att">Attachment</param>
+    /// <param name="tra">Transaction</param>
+    /// <param name="fields">Description of the record fields with FTS properties</param>
+    /// <param name="buffer">Output message buffer</param>
+    /// <param name="allField">Also index the content fields together in the catch-all field</param>
+    /// 
+    /// <returns>Document or nullptr if all indexed fields are empty</returns>
+    Lucene::DocumentPtr makeFtsDocument(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra,
+        const FTSMetadata::FbFieldsInfo& fields,
+        unsigned char* buffer,
+        bool allField = false
+    );
+
+    /// <summary>
+    /// Prepares the index for writing. 
+    /// If a shadow directory is given, the index is written there directly to disk instead of the index directory.
+    /// </summary>
     FTSPreparedIndex prepareFtsIndex(
             Firebird::ThrowStatusWrapper* status,
             Firebird::IMaster* master,
@@ -106,8 +228,9 @@ namespace LuceneUDR
             Firebird::ITransaction* tra,
             unsigned int sqlDialect,
             FTSMetadata::FTSIndex&& ftsIndex,
-            const std::filesystem::path& ftsDirectoryPath,
-            bool whereKey = false   
+            const FtsConfigPtr& ftsConfig,
+            bool whereKey = false,
+            const std::filesystem::path& shadowDirectoryPath = {}
     );
 
 }
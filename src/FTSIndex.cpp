@@ -45,6 +45,22 @@ WHERE FTS$INDEX_NAME = ?
 
     constexpr const char* SQL_SET_FTS_INDEX_STATUS = R"SQL(
 UPDATE FTS$INDICES SET FTS$INDEX_STATUS = ? WHERE FTS$INDEX_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_SET_FTS_INDEX_ALL_FIELD = R"SQL(
+UPDATE FTS$INDICES SET FTS$ALL_FIELD = ? WHERE FTS$INDEX_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_SET_FTS_INDEX_SHARD_COUNT = R"SQL(
+UPDATE FTS$INDICES SET FTS$SHARD_COUNT = ? WHERE FTS$INDEX_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_SET_FTS_INDEX_PARTITION_FIELD = R"SQL(
+UPDATE FTS$INDICES SET FTS$PARTITION_FIELD = ?, FTS$PARTITION_TYPE = ? WHERE FTS$INDEX_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_SET_FTS_INDEX_REBUILD_CHUNK_SIZE = R"SQL(
+UPDATE FTS$INDICES SET FTS$REBUILD_CHUNK_SIZE = ? WHERE FTS$INDEX_NAME = ?
 )SQL";
 
     constexpr const char* SQL_GET_FTS_INDEX = R"SQL(
@@ -53,7 +69,12 @@ SELECT
   FTS$RELATION_NAME, 
   FTS$ANALYZER, 
   FTS$DESCRIPTION, 
-  FTS$INDEX_STATUS
+  FTS$INDEX_STATUS,
+  FTS$ALL_FIELD,
+  FTS$SHARD_COUNT,
+  FTS$PARTITION_FIELD,
+  FTS$PARTITION_TYPE,
+  FTS$REBUILD_CHUNK_SIZE
 FROM FTS$INDICES
 WHERE FTS$INDEX_NAME = ?
 )SQL";
@@ -64,7 +85,12 @@ SELECT
   FTS$RELATION_NAME, 
   FTS$ANALYZER, 
   FTS$DESCRIPTION, 
-  FTS$INDEX_STATUS
+  FTS$INDEX_STATUS,
+  FTS$ALL_FIELD,
+  FTS$SHARD_COUNT,
+  FTS$PARTITION_FIELD,
+  FTS$PARTITION_TYPE,
+  FTS$REBUILD_CHUNK_SIZE
 FROM FTS$INDICES
 ORDER BY FTS$INDEX_NAME
 )SQL";
@@ -77,6 +103,12 @@ SELECT
   FTS$INDEX_SEGMENTS.FTS$FIELD_NAME,
   FTS$INDEX_SEGMENTS.FTS$KEY,
   FTS$INDEX_SEGMENTS.FTS$BOOST,
+  FTS$INDEX_SEGMENTS.FTS$SORTABLE,
+  FTS$INDEX_SEGMENTS.FTS$REVERSED,
+  FTS$INDEX_SEGMENTS.FTS$OMIT_NORMS,
+  FTS$INDEX_SEGMENTS.FTS$OMIT_POSITIONS,
+  FTS$INDEX_SEGMENTS.FTS$TERM_VECTORS,
+  FTS$INDEX_SEGMENTS.FTS$NOT_ANALYZED,
   (RF.RDB$FIELD_NAME IS NOT NULL OR RF.RDB$FIELD_NAME = 'RDB$DB_KEY') AS FIELD_EXISTS
 FROM FTS$INDICES
 JOIN FTS$INDEX_SEGMENTS
@@ -118,6 +150,27 @@ WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
 UPDATE FTS$INDEX_SEGMENTS
 SET FTS$BOOST = ?
 WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_FTS_SET_INDEX_FIELD_SORTABLE = R"SQL(
+UPDATE FTS$INDEX_SEGMENTS
+SET FTS$SORTABLE = ?
+WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_FTS_SET_INDEX_FIELD_REVERSED = R"SQL(
+UPDATE FTS$INDEX_SEGMENTS
+SET FTS$REVERSED = ?
+WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_FTS_SET_INDEX_FIELD_OPTIONS = R"SQL(
+UPDATE FTS$INDEX_SEGMENTS
+SET FTS$OMIT_NORMS = COALESCE(?, FTS$OMIT_NORMS),
+    FTS$OMIT_POSITIONS = COALESCE(?, FTS$OMIT_POSITIONS),
+    FTS$TERM_VECTORS = COALESCE(?, FTS$TERM_VECTORS),
+    FTS$NOT_ANALYZED = COALESCE(?, FTS$NOT_ANALYZED)
+WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
 )SQL";
 
     constexpr const char* SQL_HAS_INDEX_BY_ANALYZER = R"SQL(
@@ -143,6 +196,12 @@ namespace FTSMetadata
         bool key,
         double boost,
         bool boostNull,
+        bool sortable,
+        bool reversed,
+        bool omitNorms,
+        bool omitPositions,
+        bool termVectors,
+        bool notAnalyzed,
         bool fieldExists
     )
         : indexName_(indexName)
@@ -150,6 +209,12 @@ namespace FTSMetadata
         , key_(key)
         , boost_(boost)
         , boostNull_(boostNull)
+        , sortable_(sortable)
+        , reversed_(reversed)
+        , omitNorms_(omitNorms)
+        , omitPositions_(omitPositions)
+        , termVectors_(termVectors)
+        , notAnalyzed_(notAnalyzed)
         , fieldExists_(fieldExists)
     {
     }
@@ -175,6 +240,11 @@ namespace FTSMetadata
         , relationName(record->relationName.str, record->relationName.length)
         , analyzer(record->analyzer.str, record->analyzer.length)
         , status(record->indexStatus.str, record->indexStatus.length)
+        , allField(!record->allFieldNull && record->allField)
+        , shardCount(record->shardCountNull ? 1 : std::max<int>(record->shardCount, 1))
+        , partitionField(record->partitionFieldNull ? "" : std::string(record->partitionField.str, record->partitionField.length))
+        , partitionType(record->partitionTypeNull ? "VALUE" : std::string(record->partitionType.str, record->partitionType.length))
+        , rebuildChunkSize(record->rebuildChunkSizeNull ? 0 : record->rebuildChunkSize)
         , segments()
         , keyFieldType{ FTSKeyType::NONE }
     {
@@ -232,6 +302,27 @@ namespace FTSMetadata
         return s;
     }
 
+    string FTSIndex::buildSqlSelectFieldValuesChunk(
+        ThrowStatusWrapper* status,
+        unsigned int sqlDialect,
+        bool afterKey,
+        unsigned int chunkSize) const
+    {
+        auto iKeySegment = findKey();
+        if (iKeySegment == segments.end()) {
+            throwException(status, R"(Key field not exists in index "%s".)", indexName.c_str());
+        }
+        const string keyFieldName = escapeMetaName(sqlDialect, (*iKeySegment).fieldName());
+
+        std::string s = buildSqlSelectFieldValues(status, sqlDialect);
+        if (afterKey) {
+            s += "\nAND " + keyFieldName + " > ?";
+        }
+        s += "\nORDER BY " + keyFieldName;
+        s += "\nROWS " + std::to_string(chunkSize);
+        return s;
+    }
+
     //
     // FTSIndexRepository implementation
     //
@@ -418,6 +509,236 @@ namespace FTSMetadata
         );
     }
 
+    /// <summary>
+    /// Enables or disables the catch-all field of the index, 
+    /// which holds the terms of all its content fields.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="allField">Catch-all field flag</param>
+    void FTSIndexRepository::setIndexAllField(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        bool allField)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_BOOLEAN, allField)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->allField = allField;
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName);
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_SET_FTS_INDEX_ALL_FIELD,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N") {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
+    /// <summary>
+    /// Sets the number of shards the documents of the index are split into.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="shardCount">Number of shards</param>
+    void FTSIndexRepository::setIndexShardCount(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        int shardCount)
+    {
+        if (shardCount < 1 || shardCount > MAX_INDEX_SHARDS) {
+            throwException(status, "Number of shards must be between 1 and %d.", MAX_INDEX_SHARDS);
+        }
+
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_SMALLINT, shardCount)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->shardCount = static_cast<ISC_SHORT>(shardCount);
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName);
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_SET_FTS_INDEX_SHARD_COUNT,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N" && ftsIndex.shardCount != shardCount) {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
+    /// <summary>
+    /// Sets the field whose values split the documents of the index into partitions.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="partitionField">Field name, empty to remove the partitioning</param>
+    /// <param name="partitionType">VALUE or MONTH, the field of a MONTH partitioning must be a date</param>
+    void FTSIndexRepository::setIndexPartitionField(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        std::string_view partitionField,
+        std::string_view partitionType)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(252, CS_UTF8), partitionField)
+            (FB_INTL_VARCHAR(40, CS_UTF8), partitionType)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->partitionFieldNull = partitionField.empty();
+        input->partitionField.length = static_cast<ISC_USHORT>(partitionField.length());
+        partitionField.copy(input->partitionField.str, input->partitionField.length);
+
+        std::string sPartitionType{ partitionType };
+        std::transform(sPartitionType.begin(), sPartitionType.end(), sPartitionType.begin(), ::toupper);
+        if (sPartitionType != "VALUE" && sPartitionType != "MONTH") {
+            throwException(status, R"(Invalid partition type "%s". Allowed values: VALUE, MONTH.)", sPartitionType.c_str());
+        }
+        input->partitionTypeNull = partitionField.empty();
+        input->partitionType.length = static_cast<ISC_USHORT>(sPartitionType.length());
+        sPartitionType.copy(input->partitionType.str, input->partitionType.length);
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName, true);
+        // The value of the partition field is read with the other fields of the index.
+        if (!partitionField.empty()) {
+            const auto segmentIt = ftsIndex.findSegment(std::string(partitionField));
+            std::string sFieldName{ partitionField };
+            if (segmentIt == ftsIndex.segments.end()) {
+                std::string sIndexName{ indexName };
+                throwException(status, R"(Field "%s" not exists in index "%s")", sFieldName.c_str(), sIndexName.c_str());
+            }
+            if (segmentIt->isKey()) {
+                throwException(status, R"(Key field "%s" cannot be the partition field.)", sFieldName.c_str());
+            }
+            if (sPartitionType == "MONTH") {
+                const auto fieldInfo = m_relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, sFieldName);
+                if (!fieldInfo.isDateOrTimestamp()) {
+                    throwException(status, R"(Field "%s" must be of type DATE or TIMESTAMP to partition the index by month.)", sFieldName.c_str());
+                }
+            }
+        }
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_SET_FTS_INDEX_PARTITION_FIELD,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N" && (ftsIndex.partitionField != partitionField || 
+            (!partitionField.empty() && ftsIndex.partitionType != sPartitionType))) {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
+    /// <summary>
+    /// Marks the index as being rebuilt in chunks. While the mark is set, 
+    /// FTS$UPDATE_INDEXES keeps the changes of the indexed relation in FTS$LOG.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="chunkSize">Chunk size of the rebuild, 0 to remove the mark</param>
+    void FTSIndexRepository::setIndexRebuildChunkSize(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        int chunkSize)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_INTEGER, chunkSize)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->chunkSizeNull = chunkSize <= 0;
+        input->chunkSize = chunkSize;
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_SET_FTS_INDEX_REBUILD_CHUNK_SIZE,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+    }
+
     /// <summary>
     /// Checks if an index with the given name exists.
     /// </summary>
@@ -623,6 +944,12 @@ namespace FTSMetadata
             (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
             (FB_BOOLEAN, key)
             (FB_DOUBLE, boost)
+            (FB_BOOLEAN, sortable)
+            (FB_BOOLEAN, reversed)
+            (FB_BOOLEAN, omitNorms)
+            (FB_BOOLEAN, omitPositions)
+            (FB_BOOLEAN, termVectors)
+            (FB_BOOLEAN, notAnalyzed)
             (FB_BOOLEAN, fieldExists)
         ) output(status, m_master);
 
@@ -664,6 +991,12 @@ namespace FTSMetadata
                 static_cast<bool>(output->key),
                 output->boost,
                 static_cast<bool>(output->boostNull),
+                !output->sortableNull && output->sortable,
+                !output->reversedNull && output->reversed,
+                !output->omitNormsNull && output->omitNorms,
+                !output->omitPositionsNull && output->omitPositions,
+                !output->termVectorsNull && output->termVectors,
+                !output->notAnalyzedNull && output->notAnalyzed,
                 fieldExists
             );
         }
@@ -934,6 +1267,235 @@ namespace FTSMetadata
         setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
     }
 
+    /// <summary>
+    /// Sets whether search results can be sorted by the index field.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="fieldName">Field name</param>
+    /// <param name="sortable">Sortable flag</param>
+    void FTSIndexRepository::setIndexFieldSortable(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        std::string_view fieldName,
+        bool sortable)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_BOOLEAN, sortable)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+            (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->fieldName.length = static_cast<ISC_USHORT>(fieldName.length());
+        fieldName.copy(input->fieldName.str, input->fieldName.length);
+
+        input->sortable = sortable;
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName);
+
+        // Checking whether the field exists in the index.
+        if (!hasIndexField(status, att, tra, sqlDialect, indexName, fieldName)) {
+            std::string sIndexName{ indexName };
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Field "%s" not exists in index "%s")", sFieldName.c_str(), sIndexName.c_str());
+        }
+
+        if (sortable) {
+            // BLOB and DB_KEY values cannot be sorted.
+            if (fieldName == "RDB$DB_KEY") {
+                throwException(status, "Field RDB$DB_KEY cannot be sortable.");
+            }
+            const auto fieldInfo = m_relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, fieldName);
+            if (fieldInfo.isBlob()) {
+                std::string sFieldName{ fieldName };
+                throwException(status, R"(BLOB field "%s" cannot be sortable.)", sFieldName.c_str());
+            }
+        }
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_FTS_SET_INDEX_FIELD_SORTABLE,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N") {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
+    /// <summary>
+    /// Sets whether the index field has a companion field of reversed terms 
+    /// used to search with leading wildcards.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="fieldName">Field name</param>
+    /// <param name="reversed">Reversed flag</param>
+    void FTSIndexRepository::setIndexFieldReversed(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        std::string_view fieldName,
+        bool reversed)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_BOOLEAN, reversed)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+            (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->fieldName.length = static_cast<ISC_USHORT>(fieldName.length());
+        fieldName.copy(input->fieldName.str, input->fieldName.length);
+
+        input->reversed = reversed;
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // Checking whether the field exists in the index.
+        const auto segmentIt = ftsIndex.findSegment(std::string(fieldName));
+        if (segmentIt == ftsIndex.segments.end()) {
+            std::string sIndexName{ indexName };
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Field "%s" not exists in index "%s")", sFieldName.c_str(), sIndexName.c_str());
+        }
+
+        // The key is stored as is and is not searched by words.
+        if (reversed && segmentIt->isKey()) {
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Key field "%s" cannot be reversed.)", sFieldName.c_str());
+        }
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_FTS_SET_INDEX_FIELD_REVERSED,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N") {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
+    /// <summary>
+    /// Sets how the index field is indexed. NULL options keep their current values.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="fieldName">Field name</param>
+    /// <param name="omitNorms">Do not store length normalization factors and index-time boosts</param>
+    /// <param name="omitPositions">Do not store term frequencies and positions</param>
+    /// <param name="termVectors">Store term vectors with positions and offsets</param>
+    /// <param name="notAnalyzed">Index the whole value of the field as a single term</param>
+    void FTSIndexRepository::setIndexFieldOptions(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        std::string_view fieldName,
+        std::optional<bool> omitNorms,
+        std::optional<bool> omitPositions,
+        std::optional<bool> termVectors,
+        std::optional<bool> notAnalyzed)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_BOOLEAN, omitNorms)
+            (FB_BOOLEAN, omitPositions)
+            (FB_BOOLEAN, termVectors)
+            (FB_BOOLEAN, notAnalyzed)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+            (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->fieldName.length = static_cast<ISC_USHORT>(fieldName.length());
+        fieldName.copy(input->fieldName.str, input->fieldName.length);
+
+        input->omitNormsNull = !omitNorms.has_value();
+        input->omitNorms = omitNorms.value_or(false);
+        input->omitPositionsNull = !omitPositions.has_value();
+        input->omitPositions = omitPositions.value_or(false);
+        input->termVectorsNull = !termVectors.has_value();
+        input->termVectors = termVectors.value_or(false);
+        input->notAnalyzedNull = !notAnalyzed.has_value();
+        input->notAnalyzed = notAnalyzed.value_or(false);
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // Checking whether the field exists in the index.
+        const auto segmentIt = ftsIndex.findSegment(std::string(fieldName));
+        if (segmentIt == ftsIndex.segments.end()) {
+            std::string sIndexName{ indexName };
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Field "%s" not exists in index "%s")", sFieldName.c_str(), sIndexName.c_str());
+        }
+
+        // The key is always indexed as a single term without norms and positions.
+        if (segmentIt->isKey()) {
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Indexing options of key field "%s" cannot be changed.)", sFieldName.c_str());
+        }
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_FTS_SET_INDEX_FIELD_OPTIONS,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N") {
+            // set the status that the index metadata has been updated
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
     /// <summary>
     /// Checks for the existence of a field (segment) in a full-text index. 
     /// </summary>
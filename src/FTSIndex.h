@@ -17,6 +17,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_set>
 
@@ -35,10 +36,18 @@ namespace FTSMetadata
         (FB_INTL_VARCHAR(252, CS_UTF8), analyzer)
         (FB_BLOB, description)
         (FB_INTL_VARCHAR(4, CS_UTF8), indexStatus)
+        (FB_BOOLEAN, allField)
+        (FB_SMALLINT, shardCount)
+        (FB_INTL_VARCHAR(252, CS_UTF8), partitionField)
+        (FB_INTL_VARCHAR(40, CS_UTF8), partitionType)
+        (FB_INTEGER, rebuildChunkSize)
     );
 
     enum class FTSKeyType {NONE, DB_KEY, INT_ID, UUID};
 
+    // Maximum number of shards of an index.
+    constexpr int MAX_INDEX_SHARDS = 64;
+
     inline FTSKeyType FTSKeyTypeFromString(std::string_view sKeyFieldType)
     {
         FTSKeyType keyFieldType{ FTSKeyType::DB_KEY };
@@ -70,6 +79,11 @@ namespace FTSMetadata
         std::string relationName;
         std::string analyzer;
         std::string status; // N - new index, I - inactive, U - need rebuild, C - complete
+        bool allField = false; // content fields are also indexed together in the catch-all field
+        int shardCount = 1; // documents are split by key hash into this number of shards
+        std::string partitionField; // documents are split by the value of this field into partitions
+        std::string partitionType; // VALUE - a partition per value, MONTH - a partition per month of a date field
+        int rebuildChunkSize = 0; // a chunked rebuild is in progress, changes of the relation are kept in FTS$LOG
 
         FTSIndexSegmentList segments;
 
@@ -91,6 +105,26 @@ namespace FTSMetadata
             return (status == "C") || (status == "U");
         }
 
+        bool isPartitioned() const {
+            return !partitionField.empty();
+        }
+
+        bool isRebuilding() const {
+            return rebuildChunkSize > 0;
+        }
+
+        bool isPartitionedByMonth() const {
+            return isPartitioned() && partitionType == "MONTH";
+        }
+
+        /// <summary>
+        /// Returns the description of the partitioning stored with the built index, 
+        /// so that a change of the partition field or type is detected. Empty if the index is not partitioned.
+        /// </summary>
+        std::string partitioning() const {
+            return isPartitioned() ? partitionField + " " + partitionType : std::string{};
+        }
+
         bool emptySegments() const { 
             return segments.empty();
         }
@@ -106,6 +140,17 @@ namespace FTSMetadata
             unsigned int sqlDialect,
             bool whereKey = false
         ) const;
+
+        /// <summary>
+        /// Returns the query for the next chunk of records of a chunked rebuild 
+        /// in the order of the key, starting after the last key read if afterKey is set.
+        /// </summary>
+        std::string buildSqlSelectFieldValuesChunk(
+            Firebird::ThrowStatusWrapper* status,
+            unsigned int sqlDialect,
+            bool afterKey,
+            unsigned int chunkSize
+        ) const;
     };
 
 
@@ -126,6 +171,12 @@ namespace FTSMetadata
             bool key,
             double boost,
             bool boostNull,
+            bool sortable,
+            bool reversed,
+            bool omitNorms,
+            bool omitPositions,
+            bool termVectors,
+            bool notAnalyzed,
             bool fieldExists
         );
 
@@ -160,6 +211,30 @@ namespace FTSMetadata
             return boostNull_;
         }
 
+        bool isSortable() const {
+            return sortable_;
+        }
+
+        bool isReversed() const {
+            return reversed_;
+        }
+
+        bool isOmitNorms() const {
+            return omitNorms_;
+        }
+
+        bool isOmitPositions() const {
+            return omitPositions_;
+        }
+
+        bool hasTermVectors() const {
+            return termVectors_;
+        }
+
+        bool isNotAnalyzed() const {
+            return notAnalyzed_;
+        }
+
         bool isFieldExists() const {
             return fieldExists_;
         }
@@ -169,6 +244,12 @@ namespace FTSMetadata
         bool key_ = false;
         double boost_ = 1.0;
         bool boostNull_ = true;
+        bool sortable_ = false;
+        bool reversed_ = false;
+        bool omitNorms_ = false;
+        bool omitPositions_ = false;
+        bool termVectors_ = false;
+        bool notAnalyzed_ = false;
         bool fieldExists_ = false;
     };
 
@@ -270,6 +351,82 @@ namespace FTSMetadata
             std::string_view indexName,
             std::string_view indexStatus);
 
+        /// <summary>
+        /// Enables or disables the catch-all field of the index, 
+        /// which holds the terms of all its content fields.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="allField">Catch-all field flag</param>
+        void setIndexAllField(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            bool allField);
+
+        /// <summary>
+        /// Sets the number of shards the documents of the index are split into.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="shardCount">Number of shards</param>
+        void setIndexShardCount(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            int shardCount);
+
+        /// <summary>
+        /// Sets the field whose values split the documents of the index into partitions.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="partitionField">Field name, empty to remove the partitioning</param>
+        /// <param name="partitionType">VALUE or MONTH, the field of a MONTH partitioning must be a date</param>
+        void setIndexPartitionField(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            std::string_view partitionField,
+            std::string_view partitionType);
+
+        /// <summary>
+        /// Marks the index as being rebuilt in chunks. While the mark is set, 
+        /// FTS$UPDATE_INDEXES keeps the changes of the indexed relation in FTS$LOG.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="chunkSize">Chunk size of the rebuild, 0 to remove the mark</param>
+        void setIndexRebuildChunkSize(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            int chunkSize);
+
         /// <summary>
         /// Checks if an index with the given name exists.
         /// </summary>
@@ -433,6 +590,73 @@ namespace FTSMetadata
             bool boostNull = false);
 
 
+        /// <summary>
+        /// Sets whether search results can be sorted by the index field.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="fieldName">Field name</param>
+        /// <param name="sortable">Sortable flag</param>
+        void setIndexFieldSortable(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            std::string_view fieldName,
+            bool sortable);
+
+        /// <summary>
+        /// Sets whether the index field has a companion field of reversed terms 
+        /// used to search with leading wildcards.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="fieldName">Field name</param>
+        /// <param name="reversed">Reversed flag</param>
+        void setIndexFieldReversed(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            std::string_view fieldName,
+            bool reversed);
+
+        /// <summary>
+        /// Sets how the index field is indexed. NULL options keep their current values.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="fieldName">Field name</param>
+        /// <param name="omitNorms">Do not store length normalization factors and index-time boosts</param>
+        /// <param name="omitPositions">Do not store term frequencies and positions</param>
+        /// <param name="termVectors">Store term vectors with positions and offsets</param>
+        /// <param name="notAnalyzed">Index the whole value of the field as a single term</param>
+        void setIndexFieldOptions(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            std::string_view fieldName,
+            std::optional<bool> omitNorms,
+            std::optional<bool> omitPositions,
+            std::optional<bool> termVectors,
+            std::optional<bool> notAnalyzed);
+
         /// <summary>
         /// Checks for the existence of a field (segment) in a full-text index. 
         /// </summary>
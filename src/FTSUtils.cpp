@@ -1,6 +1,10 @@
 #include "FTSUtils.h"
 
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <system_error>
+#include <unordered_map>
 
 #include "FBUtils.h"
 #include "inicpp.h"
@@ -19,87 +23,233 @@
 **/
 
 using namespace Firebird;
+using namespace LuceneUDR;
 
-namespace LuceneUDR
-{
+namespace {
+
+    // How often the modification time of the settings files is checked.
+    constexpr auto FTS_CONFIG_CHECK_INTERVAL = std::chrono::seconds(2);
+
+    // Keys that can be set in fts.conf at the database level or in the "index = NAME" subsection.
+    // IConfig cannot enumerate entries, so every supported key must be listed here.
+    constexpr const char* FTS_CONF_KEYS[] = {
+        "directoryType",
+        "ftsDirectory",
+        "maxExpansions",
+        "persistInterval",
+        "searchTimeout"
+    };
+
+    struct FtsConfigCacheEntry
+    {
+        FtsConfigPtr config;
+        fs::file_time_type confFileTime;
+        fs::file_time_type iniFileTime;
+        std::chrono::steady_clock::time_point lastCheck;
+    };
+
+    std::mutex ftsConfigCacheMutex;
+    std::unordered_map<std::string, FtsConfigCacheEntry> ftsConfigCache;
+
+    fs::file_time_type getFileTime(const fs::path& filePath)
+    {
+        std::error_code ec;
+        const auto fileTime = fs::last_write_time(filePath, ec);
+        if (ec) {
+            return fs::file_time_type::min();
+        }
+        return fileTime;
+    }
+
+    void readConfOptions(ThrowStatusWrapper* status, IConfig* conf, FtsOptions& options)
+    {
+        for (const char* key : FTS_CONF_KEYS) {
+            AutoRelease<IConfigEntry> keyEntry(conf->find(status, key));
+            if (keyEntry && keyEntry->getValue()) {
+                options.insert_or_assign(key, keyEntry->getValue());
+            }
+        }
+    }
 
     /// <summary>
-    /// Returns the directory where full-text indexes are located.
+    /// Reads the database settings from fts.conf. 
     /// </summary>
     /// 
-    /// <param name="status">Status. </param>
-    /// <param name="context">The context of the external routine.</param>
-    /// 
-    /// <returns>Full path to full-text index directory</returns>
-    fs::path getFtsDirectory(ThrowStatusWrapper* status, IExternalContext* context) 
-    try {
-        const auto pluginManager = context->getMaster()->getPluginManager();
-        IConfigManager* configManager = context->getMaster()->getConfigManager();
-
-        const std::string databaseName(context->getDatabaseName());
-        const std::string rootDir(configManager->getRootDirectory());
-        const fs::path rootDirPath = rootDir;
+    /// <returns>false if fts.conf cannot be read by the plugin manager</returns>
+    bool loadFtsConf(ThrowStatusWrapper* status, IMaster* master, const fs::path& confFilePath, 
+        const std::string& databaseName, FtsConfig& config)
+    {
+        AutoRelease<IConfig> conf(master->getPluginManager()->getConfig(status, confFilePath.string().c_str()));
+        if (!conf) {
+            return false;
+        }
+        AutoRelease<IConfigEntry> ftsEntry(conf->findValue(status, "database", databaseName.c_str()));
+        if (!ftsEntry) {
+            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Entry "database = %s" not found in file fts.conf)", databaseName.c_str());
+            throw Firebird::FbException(status, statusVector);
+        }
+        AutoRelease<IConfig> subConf(ftsEntry->getSubConfig(status));
+        if (!subConf) {
+            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in entry "database = %s" file fts.conf)", databaseName.c_str());
+            throw Firebird::FbException(status, statusVector);
+        }
+        readConfOptions(status, subConf, config.options);
+        auto dirIt = config.options.find("ftsDirectory");
+        if (dirIt == config.options.end()) {
+            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in entry "database = %s" file fts.conf)", databaseName.c_str());
+            throw Firebird::FbException(status, statusVector);
+        }
+        config.ftsDirectory = dirIt->second;
 
-        const fs::path confFilePath = rootDirPath / "fts.conf";
-        if (fs::exists(confFilePath)) {
-            AutoRelease<IConfig> conf = pluginManager->getConfig(status, confFilePath.string().c_str());
-            if (conf) {
-                AutoRelease<IConfigEntry> ftsEntry(conf->findValue(status, "database", context->getDatabaseName()));
-                if (ftsEntry) {
-                    AutoRelease<IConfig> subConf(ftsEntry->getSubConfig(status));
-                    if (subConf) {
-                        AutoRelease<IConfigEntry> dirEntry(subConf->find(status, "ftsDirectory"));
-                        if (dirEntry) {
-                            fs::path ftsDirectoryPath(dirEntry->getValue());
-                            return ftsDirectoryPath;
-                        }
-                        else {
-                            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in entry "database = %s" file fts.conf)", databaseName.c_str());
-                            throw Firebird::FbException(status, statusVector);
-                        }
-                    }
-                    else {
-                        IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in entry "database = %s" file fts.conf)", databaseName.c_str());
-                        throw Firebird::FbException(status, statusVector);
-                    }
-                }
-                else {
-                    IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Entry "database = %s" not found in file fts.conf)", databaseName.c_str());
-                    throw Firebird::FbException(status, statusVector);
-                }
+        // index = NAME { key = value }
+        for (unsigned pos = 0; ; pos++) {
+            AutoRelease<IConfigEntry> indexEntry(subConf->findPos(status, "index", pos));
+            if (!indexEntry) {
+                break;
+            }
+            if (!indexEntry->getValue()) {
+                continue;
+            }
+            AutoRelease<IConfig> indexConf(indexEntry->getSubConfig(status));
+            if (indexConf) {
+                readConfOptions(status, indexConf, config.indexOptions[indexEntry->getValue()]);
             }
         }
+        return true;
+    }
 
-        const fs::path iniFilePath = rootDirPath / "fts.ini";
-        if (fs::exists(iniFilePath)) {
+    /// <summary>
+    /// Reads the database settings from fts.ini. 
+    /// Keys of the form INDEX_NAME.key set options of individual indexes.
+    /// </summary>
+    void loadFtsIni(ThrowStatusWrapper* status, const fs::path& iniFilePath, const std::string& databaseName, FtsConfig& config)
+    {
 #ifdef WIN32_LEAN_AND_MEAN
-            ini::IniFileCaseInsensitive iniFile;
+        ini::IniFileCaseInsensitive iniFile;
 #else
-            ini::IniFile iniFile;
+        ini::IniFile iniFile;
 #endif
-            iniFile.load(iniFilePath.u8string());
-            auto secIt = iniFile.find(databaseName);
-            if (secIt == iniFile.end()) {
-                IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Section "%s" not found in file fts.ini)", databaseName.c_str());
-                throw Firebird::FbException(status, statusVector);
+        iniFile.load(iniFilePath.u8string());
+        auto secIt = iniFile.find(databaseName);
+        if (secIt == iniFile.end()) {
+            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Section "%s" not found in file fts.ini)", databaseName.c_str());
+            throw Firebird::FbException(status, statusVector);
+        }
+        auto&& section = secIt->second;
+        auto keyIt = section.find("ftsDirectory");
+        if (keyIt == section.end()) {
+            IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in section "%s" file fts.ini)", databaseName.c_str());
+            throw Firebird::FbException(status, statusVector);
+        }
+        config.ftsDirectory = keyIt->second.as<std::string>();
+
+        for (auto&& [key, value] : section) {
+            const auto dotPos = key.rfind('.');
+            if (dotPos == std::string::npos) {
+                config.options.insert_or_assign(key, value.as<std::string>());
             }
-            auto&& section = secIt->second;
-            auto keyIt = section.find("ftsDirectory");
-            if (keyIt == section.end()) {
-                IscRandomStatus statusVector = IscRandomStatus::createFmtStatus(R"(Key ftsDirectory not found in section "%s" file fts.ini)", databaseName.c_str());
-                throw Firebird::FbException(status, statusVector);
+            else {
+                config.indexOptions[key.substr(0, dotPos)].insert_or_assign(key.substr(dotPos + 1), value.as<std::string>());
             }
-            auto&& key = keyIt->second;
-            const auto ftsDirectory = key.as<std::string>();
-            return { ftsDirectory };
         }
-        else {
-            IscRandomStatus statusVector("Settings file fts.ini or fts.conf not found");
-            throw Firebird::FbException(status, statusVector);
+    }
+}
+
+namespace LuceneUDR
+{
+
+    std::string FtsConfig::getOption(std::string_view indexName, std::string_view key, std::string_view defaultValue) const
+    {
+        if (auto indexIt = indexOptions.find(indexName); indexIt != indexOptions.end()) {
+            if (auto optionIt = indexIt->second.find(key); optionIt != indexIt->second.end()) {
+                return optionIt->second;
+            }
+        }
+        if (auto optionIt = options.find(key); optionIt != options.end()) {
+            return optionIt->second;
         }
+        return std::string(defaultValue);
+    }
+
+    FtsConfigPtr getFtsConfig(ThrowStatusWrapper* status, IExternalContext* context)
+    try {
+        const std::string databaseName(context->getDatabaseName());
+        const auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(ftsConfigCacheMutex);
+
+        auto& entry = ftsConfigCache[databaseName];
+        if (entry.config && now - entry.lastCheck < FTS_CONFIG_CHECK_INTERVAL) {
+            return entry.config;
+        }
+
+        IConfigManager* configManager = context->getMaster()->getConfigManager();
+        const fs::path rootDirPath = std::string(configManager->getRootDirectory());
+        const fs::path confFilePath = rootDirPath / "fts.conf";
+        const fs::path iniFilePath = rootDirPath / "fts.ini";
+
+        const auto confFileTime = getFileTime(confFilePath);
+        const auto iniFileTime = getFileTime(iniFilePath);
+        if (entry.config && entry.confFileTime == confFileTime && entry.iniFileTime == iniFileTime) {
+            entry.lastCheck = now;
+            return entry.config;
+        }
+
+        auto config = std::make_shared<FtsConfig>();
+        bool loaded = false;
+        if (confFileTime != fs::file_time_type::min()) {
+            loaded = loadFtsConf(status, context->getMaster(), confFilePath, databaseName, *config);
+        }
+        if (!loaded) {
+            if (iniFileTime == fs::file_time_type::min()) {
+                IscRandomStatus statusVector("Settings file fts.ini or fts.conf not found");
+                throw Firebird::FbException(status, statusVector);
+            }
+            loadFtsIni(status, iniFilePath, databaseName, *config);
+        }
+
+        entry.config = std::move(config);
+        entry.confFileTime = confFileTime;
+        entry.iniFileTime = iniFileTime;
+        entry.lastCheck = now;
+        return entry.config;
     }
     catch (const std::exception& e) {
         IscRandomStatus statusVector(e);
         throw Firebird::FbException(status, statusVector);
     }
+
+    std::string queryEscape(std::string_view query)
+    {
+        std::string s;
+        s.reserve(query.size() * 2);
+        for (auto ch : query) {
+            switch (ch) {
+            case '+':
+            case '-':
+            case '!':
+            case '^':
+            case '"':
+            case '~':
+            case '*':
+            case '?':
+            case ':':
+            case '\\':
+            case '&':
+            case '|':
+            case '(':
+            case ')':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+                s += '\\';
+                s += ch;
+                break;
+            default:
+                s += ch;
+            }
+        }
+        return s;
+    }
 }
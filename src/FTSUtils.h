@@ -15,6 +15,10 @@
 **/
 
 #include <filesystem> 
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
 
 #include "LuceneUdr.h"
 
@@ -23,6 +27,49 @@ namespace fs = std::filesystem;
 namespace LuceneUDR
 {
 
+    using FtsOptions = std::map<std::string, std::string, std::less<>>;
+
+    /// <summary>
+    /// Lucene UDR settings of a database read from fts.conf or fts.ini.
+    /// </summary>
+    struct FtsConfig
+    {
+        // directory where full-text indexes are located
+        fs::path ftsDirectory;
+        // database level options
+        FtsOptions options;
+        // options of individual indexes, they override database level options
+        std::map<std::string, FtsOptions, std::less<>> indexOptions;
+
+        /// <summary>
+        /// Returns the value of the option for the index. 
+        /// If the option is not set for the index, the database level value is returned.
+        /// </summary>
+        /// 
+        /// <param name="indexName">Index name</param>
+        /// <param name="key">Option name</param>
+        /// <param name="defaultValue">Value returned when the option is not set</param>
+        /// 
+        /// <returns>Option value</returns>
+        std::string getOption(std::string_view indexName, std::string_view key, std::string_view defaultValue = {}) const;
+    };
+
+    using FtsConfigPtr = std::shared_ptr<const FtsConfig>;
+
+    /// <summary>
+    /// Returns the Lucene UDR settings of the current database. 
+    /// 
+    /// Settings are cached for the whole process and keyed by the database name. 
+    /// The modification time of the settings files is checked no more often than once per FTS_CONFIG_CHECK_INTERVAL, 
+    /// and the settings are reloaded only if the files have changed.
+    /// </summary>
+    /// 
+    /// <param name="status">Status</param>
+    /// <param name="context">The context of the external routine.</param>
+    /// 
+    /// <returns>Database settings</returns>
+    FtsConfigPtr getFtsConfig(Firebird::ThrowStatusWrapper* status, Firebird::IExternalContext* context);
+
     /// <summary>
     /// Returns the directory where full-text indexes are located.
     /// </summary>
@@ -30,7 +77,19 @@ namespace LuceneUDR
     /// <param name="context">The context of the external routine.</param>
     /// 
     /// <returns>Full path to full-text index directory</returns>
-    fs::path getFtsDirectory(Firebird::ThrowStatusWrapper* status, Firebird::IExternalContext* context);
+    inline fs::path getFtsDirectory(Firebird::ThrowStatusWrapper* status, Firebird::IExternalContext* context)
+    {
+        return getFtsConfig(status, context)->ftsDirectory;
+    }
+
+    /// <summary>
+    /// Escapes the special characters of the Lucene query syntax.
+    /// </summary>
+    /// 
+    /// <param name="query">Query text</param>
+    /// 
+    /// <returns>Query text where each special character is preceded by a backslash</returns>
+    std::string queryEscape(std::string_view query);
 
     inline bool createIndexDirectory(const fs::path& indexDir)
     {
@@ -18,6 +18,7 @@
 #include "LuceneAnalyzerFactory.h"
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
+#include "NGramAnalyzer.h"
 #include "QueryScorer.h"
 #include "SimpleHTMLFormatter.h"
 #include "SimpleSpanFragmenter.h"
@@ -122,7 +123,7 @@ FB_UDR_BEGIN_FUNCTION(bestFragementHighligh)
             const unsigned int sqlDialect = getSqlDialect(status, att);
 
             auto analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, analyzerName);
-            auto parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, StringUtils::toUnicode(fieldName), analyzer);
+            auto parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, StringUtils::toUnicode(fieldName), NGramAnalyzer::getQueryAnalyzer(analyzer));
             auto query = parser->parse(StringUtils::toUnicode(queryStr));
             auto formatter = newLucene<SimpleHTMLFormatter>(StringUtils::toUnicode(leftTag), StringUtils::toUnicode(rightTag));
             auto scorer = newLucene<QueryScorer>(query);
@@ -246,7 +247,7 @@ FB_UDR_BEGIN_PROCEDURE(bestFragementsHighligh)
             const unsigned int sqlDialect = getSqlDialect(status, att);
 
             auto analyzer = procedure->analyzers->createAnalyzer(status, att, tra, sqlDialect, analyzerName);
-            auto parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, StringUtils::toUnicode(fieldName), analyzer);
+            auto parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, StringUtils::toUnicode(fieldName), NGramAnalyzer::getQueryAnalyzer(analyzer));
             auto query = parser->parse(StringUtils::toUnicode(queryStr));
             auto formatter = newLucene<SimpleHTMLFormatter>(StringUtils::toUnicode(leftTag), StringUtils::toUnicode(rightTag));
             auto scorer = newLucene<QueryScorer>(query);
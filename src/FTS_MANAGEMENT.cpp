@@ -20,10 +20,12 @@
 #include "FTSHelper.h"
 #include "FTSIndex.h"
 #include "FTSUtils.h"
+#include "IndexDirectory.h"
 #include "LuceneAnalyzerFactory.h"
 #include "LuceneUdr.h"
 #include "LuceneHeaders.h"
 #include "Relations.h"
+#include "SpellIndex.h"
 
 namespace fs = std::filesystem;
 
@@ -469,10 +471,19 @@ FB_UDR_BEGIN_PROCEDURE(dropIndex)
 
         const auto ftsDirectoryPath = getFtsDirectory(status, context);
         const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        releaseIndexDirectory(indexDirectoryPath);
         // If the directory exists, then delete it.
         if (!removeIndexDirectory(indexDirectoryPath)) {
             throwException(status, R"(Cannot delete index directory "%s".)", indexDirectoryPath.u8string().c_str());
         }
+        const auto spellDirectoryPath = getSpellDirectoryPath(indexDirectoryPath);
+        if (!removeIndexDirectory(spellDirectoryPath)) {
+            throwException(status, R"(Cannot delete index directory "%s".)", spellDirectoryPath.u8string().c_str());
+        }
+        const auto shadowDirectoryPath = getShadowIndexDirectoryPath(indexDirectoryPath);
+        if (!removeIndexDirectory(shadowDirectoryPath)) {
+            throwException(status, R"(Cannot delete index directory "%s".)", shadowDirectoryPath.u8string().c_str());
+        }
     }
 
     FB_UDR_FETCH_PROCEDURE
@@ -706,9 +717,458 @@ FB_UDR_BEGIN_PROCEDURE(setIndexFieldBoost)
 FB_UDR_END_PROCEDURE
 
 
+/***
+PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$SORTABLE BOOLEAN NOT NULL
+)
+EXTERNAL NAME 'luceneudr!setIndexFieldSortable'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexFieldSortable)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_BOOLEAN, sortable)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        std::string_view fieldName(in->fieldName.str, in->fieldName.length);
+        const bool sortable = !in->sortableNull && in->sortable;
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexFieldSortable(status, att, tra, sqlDialect, indexName, fieldName, sortable);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SET_INDEX_FIELD_REVERSED (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$REVERSED BOOLEAN NOT NULL
+)
+EXTERNAL NAME 'luceneudr!setIndexFieldReversed'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexFieldReversed)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_BOOLEAN, reversed)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        std::string_view fieldName(in->fieldName.str, in->fieldName.length);
+        const bool reversed = !in->reversedNull && in->reversed;
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexFieldReversed(status, att, tra, sqlDialect, indexName, fieldName, reversed);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SET_INDEX_FIELD_OPTIONS (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$OMIT_NORMS BOOLEAN,
+     FTS$OMIT_POSITIONS BOOLEAN,
+     FTS$TERM_VECTORS BOOLEAN,
+     FTS$NOT_ANALYZED BOOLEAN
+)
+EXTERNAL NAME 'luceneudr!setIndexFieldOptions'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexFieldOptions)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_BOOLEAN, omitNorms)
+        (FB_BOOLEAN, omitPositions)
+        (FB_BOOLEAN, termVectors)
+        (FB_BOOLEAN, notAnalyzed)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        std::string_view fieldName(in->fieldName.str, in->fieldName.length);
+
+        // NULL keeps the current value of the option
+        auto toOptional = [](ISC_SHORT isNull, FB_BOOLEAN value) -> std::optional<bool> {
+            if (isNull) {
+                return std::nullopt;
+            }
+            return static_cast<bool>(value);
+        };
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexFieldOptions(
+            status, att, tra, sqlDialect, indexName, fieldName,
+            toOptional(in->omitNormsNull, in->omitNorms),
+            toOptional(in->omitPositionsNull, in->omitPositions),
+            toOptional(in->termVectorsNull, in->termVectors),
+            toOptional(in->notAnalyzedNull, in->notAnalyzed)
+        );
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SET_INDEX_ALL_FIELD (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$ALL_FIELD BOOLEAN NOT NULL
+)
+EXTERNAL NAME 'luceneudr!setIndexAllField'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexAllField)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_BOOLEAN, allField)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        const bool allField = !in->allFieldNull && in->allField;
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexAllField(status, att, tra, sqlDialect, indexName, allField);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SET_INDEX_SHARD_COUNT (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$SHARD_COUNT SMALLINT NOT NULL
+)
+EXTERNAL NAME 'luceneudr!setIndexShardCount'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexShardCount)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_SMALLINT, shardCount)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        if (in->shardCountNull) {
+            throwException(status, "FTS$SHARD_COUNT can not be NULL");
+        }
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexShardCount(status, att, tra, sqlDialect, indexName, in->shardCount);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SET_INDEX_PARTITION (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+     FTS$PARTITION_TYPE VARCHAR(10) CHARACTER SET UTF8 NOT NULL DEFAULT 'VALUE'
+)
+EXTERNAL NAME 'luceneudr!setIndexPartition'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexPartition)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_INTL_VARCHAR(40, CS_UTF8), partitionType)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        // NULL removes the partitioning
+        std::string_view fieldName;
+        if (!in->fieldNameNull) {
+            fieldName = std::string_view(in->fieldName.str, in->fieldName.length);
+        }
+        std::string_view partitionType(in->partitionType.str, in->partitionType.length);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexPartitionField(status, att, tra, sqlDialect, indexName, fieldName, partitionType);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+
+namespace
+{
+    // Sets or removes the mark of a chunked rebuild, and the completion status with its removal. 
+    // This is done in an autonomous transaction, so that the mark is seen by FTS$UPDATE_INDEXES at once.
+    void setRebuildChunkSize(ThrowStatusWrapper* status, IAttachment* att, FTSIndexRepository& indexRepository, 
+        unsigned int sqlDialect, const std::string& indexName, unsigned int chunkSize, bool complete)
+    {
+        // does not wait for the caller's transaction, if it has changed the index metadata
+        const unsigned char tpb[] = {
+            isc_tpb_version3,
+            isc_tpb_write,
+            isc_tpb_read_committed,
+            isc_tpb_rec_version,
+            isc_tpb_nowait
+        };
+        AutoRelease<ITransaction> markTra(att->startTransaction(status, sizeof(tpb), tpb));
+        try {
+            indexRepository.setIndexRebuildChunkSize(status, att, markTra, sqlDialect, indexName, static_cast<int>(chunkSize));
+            if (complete) {
+                indexRepository.setIndexStatus(status, att, markTra, sqlDialect, indexName, "C");
+            }
+            markTra->commit(status);
+            markTra.release();
+        }
+        catch (...) {
+            markTra->rollback(status);
+            markTra.release();
+            throw;
+        }
+    }
+
+    // A failed chunked rebuild that has committed chunks can be resumed, so the changes of the table stay in FTS$LOG. 
+    // Otherwise the mark is removed and the changes are applied to the current index again.
+    void cancelChunkedRebuild(ThrowStatusWrapper* status, IAttachment* att, FTSIndexRepository& indexRepository,
+        unsigned int sqlDialect, const std::string& indexName, const fs::path& shadowDirectoryPath)
+    {
+        if (readRebuildCheckpoint(shadowDirectoryPath)) {
+            return;
+        }
+        try {
+            setRebuildChunkSize(status, att, indexRepository, sqlDialect, indexName, 0, false);
+        }
+        catch (...) {
+            // the error of the rebuild is reported
+        }
+    }
+
+    // Reads the next chunk of a chunked rebuild in its own short read-only transaction, 
+    // so that no snapshot is held during the whole rebuild.
+    unsigned int rebuildChunk(ThrowStatusWrapper* status, IAttachment* att, unsigned int sqlDialect,
+        FTSPreparedIndex& preparedIndex, std::string& lastKey, unsigned int chunkSize, bool replace)
+    {
+        const unsigned char tpb[] = {
+            isc_tpb_version3,
+            isc_tpb_read,
+            isc_tpb_read_committed,
+            isc_tpb_rec_version
+        };
+        AutoRelease<ITransaction> chunkTra(att->startTransaction(status, sizeof(tpb), tpb));
+        try {
+            const auto count = preparedIndex.rebuildChunk(status, att, chunkTra, sqlDialect, lastKey, chunkSize, replace);
+            chunkTra->commit(status);
+            chunkTra.release();
+            return count;
+        }
+        catch (...) {
+            chunkTra->rollback(status);
+            chunkTra.release();
+            throw;
+        }
+    }
+
+    // Reads the table in chunks after the last key. Each chunk is committed to the shadow directory 
+    // and then recorded in the checkpoint, from which an interrupted rebuild is resumed.
+    void rebuildInChunks(ThrowStatusWrapper* status, IAttachment* att, unsigned int sqlDialect,
+        FTSPreparedIndex& preparedIndex, const fs::path& shadowDirectoryPath, int shardCount,
+        std::string lastKey, unsigned int chunkSize, bool replace)
+    {
+        unsigned int count = 0;
+        do {
+            count = rebuildChunk(status, att, sqlDialect, preparedIndex, lastKey, chunkSize, replace);
+            preparedIndex.commit(status);
+            if (count > 0 && !writeRebuildCheckpoint(shadowDirectoryPath, { shardCount, lastKey })) {
+                throwException(status, R"(Cannot write the rebuild checkpoint to "%s".)", shadowDirectoryPath.u8string().c_str());
+            }
+        } while (count == chunkSize);
+    }
+
+    // Completes the rebuilt index and replaces the current index with it.
+    void swapRebuiltIndex(ThrowStatusWrapper* status, FTSPreparedIndex& preparedIndex,
+        const fs::path& indexDirectoryPath, const fs::path& shadowDirectoryPath, 
+        int shardCount, bool partitioned, bool spellIndex, const Collection<String>& spellFields)
+    {
+        preparedIndex.optimize(status); 
+        preparedIndex.commit(status);
+        preparedIndex.close(status);
+
+        removeRebuildCheckpoint(shadowDirectoryPath);
+        if (!swapIndexDirectory(indexDirectoryPath, shadowDirectoryPath)) {
+            throwException(status, R"(Cannot replace index directory "%s" with "%s".)", 
+                indexDirectoryPath.u8string().c_str(), shadowDirectoryPath.u8string().c_str());
+        }
+
+        // the spellchecker index is built from the rebuilt terms, a disabled one is removed
+        if (spellIndex) {
+            buildSpellIndex(indexDirectoryPath, getAllIndexShardPaths(getIndexGenerationPath(indexDirectoryPath), shardCount, partitioned), spellFields);
+        }
+        else {
+            const auto spellDirectoryPath = getSpellDirectoryPath(indexDirectoryPath);
+            if (!removeIndexDirectory(spellDirectoryPath)) {
+                throwException(status, R"(Cannot delete index directory "%s".)", spellDirectoryPath.u8string().c_str());
+            }
+        }
+    }
+}
+
 /***
 PROCEDURE FTS$REBUILD_INDEX (
-    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$CHUNK_SIZE INTEGER
 )
 EXTERNAL NAME 'luceneudr!rebuildIndex'
 ENGINE UDR;
@@ -716,6 +1176,7 @@ ENGINE UDR;
 FB_UDR_BEGIN_PROCEDURE(rebuildIndex)
     FB_UDR_MESSAGE(InMessage,
         (FB_INTL_VARCHAR(252, CS_UTF8), index_name)
+        (FB_INTEGER, chunk_size)
     );
 
     FB_UDR_CONSTRUCTOR
@@ -739,8 +1200,13 @@ FB_UDR_BEGIN_PROCEDURE(rebuildIndex)
         AutoRelease<ITransaction> tra(context->getTransaction(status));
 
         const std::string indexName(in->index_name.str, in->index_name.length);
+        if (!in->chunk_sizeNull && in->chunk_size <= 0) {
+            throwException(status, "Chunk size must be greater than zero.");
+        }
+        const unsigned int chunkSize = in->chunk_sizeNull ? 0 : static_cast<unsigned int>(in->chunk_size);
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -748,25 +1214,168 @@ FB_UDR_BEGIN_PROCEDURE(rebuildIndex)
 
         const unsigned int sqlDialect = getSqlDialect(status, att);
 
+        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        // The index is rebuilt in a shadow directory, searches keep using the current index until it is swapped.
+        // A changed number of shards or partitioning is applied by the new layout.
+        const auto shadowDirectoryPath = getShadowIndexDirectoryPath(indexDirectoryPath);
+        bool chunkedRebuild = false;
         try {
             // get FTS index metadata
             auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+            const bool wasRebuilding = ftsIndex.isRebuilding();
+            const auto spellFields = getSpellFields(ftsIndex);
+            const bool spellIndex = isSpellIndexEnabled(status, *ftsConfig, indexName) && 
+                procedure->indexRepository->getAnalyzerRepository()->isWordPreserving(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            const int shardCount = ftsIndex.shardCount;
+            const bool partitioned = ftsIndex.isPartitioned();
+            if (isIndexDirectoryLocked(shadowDirectoryPath)) {
+                throwException(status, R"(Index "%s" is already being rebuilt.)", indexName.c_str());
+            }
+            // the remains of an interrupted rebuild
+            if (!removeIndexDirectory(shadowDirectoryPath) || !prepareIndexLayout(shadowDirectoryPath, shardCount, ftsIndex.partitioning())) {
+                throwException(status, R"(Cannot clear index directory "%s".)", shadowDirectoryPath.u8string().c_str());
+            }
+            if (chunkSize > 0) {
+                // From now on FTS$UPDATE_INDEXES keeps the changes of the table in FTS$LOG, 
+                // they are applied to the rebuilt index after it is swapped in, 
+                // including the changes of records that were already read.
+                setRebuildChunkSize(status, att, *procedure->indexRepository, sqlDialect, indexName, chunkSize, false);
+                chunkedRebuild = true;
+            }
             // prepare index to rebuild
             auto preparedIndex = prepareFtsIndex(
                 status, context->getMaster(), att, tra, sqlDialect, 
-                std::move(ftsIndex), ftsDirectoryPath);
-
-            preparedIndex.deleteAll(status);
-            preparedIndex.commit(status);
+                std::move(ftsIndex), ftsConfig, false, shadowDirectoryPath);
 
-            preparedIndex.rebuild(status, att, tra);
+            if (chunkedRebuild) {
+                rebuildInChunks(status, att, sqlDialect, preparedIndex, shadowDirectoryPath, shardCount, {}, chunkSize, false);
+            }
+            else {
+                preparedIndex.rebuild(status, att, tra);
+            }
 
-            preparedIndex.optimize(status); 
-            preparedIndex.commit(status);
-            preparedIndex.close(status);
+            swapRebuiltIndex(status, preparedIndex, indexDirectoryPath, shadowDirectoryPath, shardCount, partitioned, spellIndex, spellFields);
 
             // if the index building was successful, then set the indexing completion status
-            procedure->indexRepository->setIndexStatus(status, att, tra, sqlDialect, indexName, "C");
+            if (chunkedRebuild) {
+                // the changes kept in FTS$LOG are applied by the next FTS$UPDATE_INDEXES
+                setRebuildChunkSize(status, att, *procedure->indexRepository, sqlDialect, indexName, 0, true);
+                chunkedRebuild = false;
+            }
+            else {
+                if (wasRebuilding) {
+                    // an interrupted chunked rebuild is replaced by this one
+                    procedure->indexRepository->setIndexRebuildChunkSize(status, att, tra, sqlDialect, indexName, 0);
+                }
+                procedure->indexRepository->setIndexStatus(status, att, tra, sqlDialect, indexName, "C");
+            }
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            if (chunkedRebuild) {
+                cancelChunkedRebuild(status, att, *procedure->indexRepository, sqlDialect, indexName, shadowDirectoryPath);
+            }
+            throwException(status, error_message.c_str());
+        }
+        catch (...) {
+            if (chunkedRebuild) {
+                cancelChunkedRebuild(status, att, *procedure->indexRepository, sqlDialect, indexName, shadowDirectoryPath);
+            }
+            throw;
+        }
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$RESUME_REBUILD (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
+)
+EXTERNAL NAME 'luceneudr!resumeRebuild'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(resumeRebuild)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), index_name)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository{nullptr};
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const std::string indexName(in->index_name.str, in->index_name.length);
+
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
+        // check if there is a directory for full-text indexes
+        if (!fs::is_directory(ftsDirectoryPath)) {
+            throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
+        }
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        const auto shadowDirectoryPath = getShadowIndexDirectoryPath(indexDirectoryPath);
+        try {
+            // get FTS index metadata
+            auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+            if (!ftsIndex.isRebuilding()) {
+                throwException(status, R"(Index "%s" has no interrupted chunked rebuild to resume.)", indexName.c_str());
+            }
+            const auto spellFields = getSpellFields(ftsIndex);
+            const bool spellIndex = isSpellIndexEnabled(status, *ftsConfig, indexName) && 
+                procedure->indexRepository->getAnalyzerRepository()->isWordPreserving(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            const int shardCount = ftsIndex.shardCount;
+            const bool partitioned = ftsIndex.isPartitioned();
+            const auto chunkSize = static_cast<unsigned int>(ftsIndex.rebuildChunkSize);
+            if (isIndexDirectoryLocked(shadowDirectoryPath)) {
+                throwException(status, R"(Index "%s" is already being rebuilt.)", indexName.c_str());
+            }
+            // The documents up to the key of the checkpoint are committed, the rebuild continues after it. 
+            // Documents committed after the checkpoint are read again and replace their copies.
+            const auto checkpoint = readRebuildCheckpoint(shadowDirectoryPath);
+            if (checkpoint && checkpoint->shardCount != shardCount) {
+                throwException(status, R"(The number of shards of index "%s" has changed since the rebuild was started, it must be rebuilt.)", indexName.c_str());
+            }
+            if (!checkpoint) {
+                // no chunk was committed, the rebuild starts anew
+                if (!removeIndexDirectory(shadowDirectoryPath) || !prepareIndexLayout(shadowDirectoryPath, shardCount, ftsIndex.partitioning())) {
+                    throwException(status, R"(Cannot clear index directory "%s".)", shadowDirectoryPath.u8string().c_str());
+                }
+            }
+            // the partitioning of the shadow directory is checked against the index metadata
+            auto preparedIndex = prepareFtsIndex(
+                status, context->getMaster(), att, tra, sqlDialect,
+                std::move(ftsIndex), ftsConfig, false, shadowDirectoryPath);
+
+            rebuildInChunks(status, att, sqlDialect, preparedIndex, shadowDirectoryPath, shardCount,
+                checkpoint ? checkpoint->lastKey : std::string{}, chunkSize, checkpoint.has_value());
+
+            swapRebuiltIndex(status, preparedIndex, indexDirectoryPath, shadowDirectoryPath, shardCount, partitioned, spellIndex, spellFields);
+
+            // the changes kept in FTS$LOG are applied by the next FTS$UPDATE_INDEXES
+            setRebuildChunkSize(status, att, *procedure->indexRepository, sqlDialect, indexName, 0, true);
         }
         catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
@@ -815,7 +1424,8 @@ FB_UDR_BEGIN_PROCEDURE(optimizeIndex)
 
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);	
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -825,7 +1435,7 @@ FB_UDR_BEGIN_PROCEDURE(optimizeIndex)
 
         try {
             // get FTS index metadata
-            auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
+            auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
             // Check if the index directory exists. 
             const auto& indexDirectoryPath = ftsDirectoryPath / indexName;
             if (!fs::is_directory(indexDirectoryPath)) {
@@ -834,14 +1444,39 @@ FB_UDR_BEGIN_PROCEDURE(optimizeIndex)
 
             const auto analyzers = procedure->indexRepository->getAnalyzerRepository();
 
-            auto fsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
             auto analyzer = analyzers->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
-            auto writer = newLucene<IndexWriter>(fsIndexDir, analyzer, false, IndexWriter::MaxFieldLengthUNLIMITED);
+            const auto generationPath = getIndexGenerationPath(indexDirectoryPath);
+            const auto shardPaths = getAllIndexShardPaths(generationPath, ftsIndex.shardCount, ftsIndex.isPartitioned());
+            // Only the newest month of an index partitioned by month takes new documents. 
+            // Older months are merged once and then left as they are.
+            std::vector<fs::path> coldShardPaths;
+            if (ftsIndex.isPartitionedByMonth()) {
+                const auto partitionPaths = getIndexPartitionPaths(generationPath);
+                for (size_t i = 0; i + 1 < partitionPaths.size(); i++) {
+                    const auto partitionShardPaths = getIndexShardPaths(partitionPaths[i], ftsIndex.shardCount);
+                    coldShardPaths.insert(coldShardPaths.end(), partitionShardPaths.cbegin(), partitionShardPaths.cend());
+                }
+            }
+            for (const auto& shardPath : shardPaths) {
+                if (std::find(coldShardPaths.cbegin(), coldShardPaths.cend(), shardPath) != coldShardPaths.cend() &&
+                    isIndexOptimized(status, *ftsConfig, indexName, shardPath)) 
+                {
+                    continue;
+                }
+                auto indexDir = openIndexWriterDirectory(status, *ftsConfig, indexName, shardPath);
+                auto writer = newLucene<IndexWriter>(indexDir, analyzer, false, IndexWriter::MaxFieldLengthUNLIMITED);
+
+                // clean up index directory
+                writer->optimize();
+                writer->close();
+                commitIndexDirectory(status, *ftsConfig, indexName, shardPath);
+                indexDir->close();
+            }
 
-            // clean up index directory
-            writer->optimize();
-            writer->close();
-            fsIndexDir->close();
+            // optimizing also drops the words of deleted documents from the spellchecker index
+            if (fs::is_directory(getSpellDirectoryPath(indexDirectoryPath))) {
+                buildSpellIndex(indexDirectoryPath, shardPaths, getSpellFields(ftsIndex));
+            }
         }
         catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 
 #include "LuceneUdr.h"
 #include "LuceneHeaders.h"
@@ -25,6 +26,7 @@
 #include "FileUtils.h"
 #include "FTSIndex.h"
 #include "FTSUtils.h"
+#include "IndexDirectory.h"
 #include "IndexFileNameFilter.h"
 #include "IndexFileNames.h"
 #include "LuceneFiles.h"
@@ -38,6 +40,47 @@ using namespace Lucene;
 using namespace LuceneUDR;
 using namespace FTSMetadata;
 
+namespace
+{
+    /// <summary>
+    /// Opens the directory of an index without shards and partitions. 
+    /// The files and segments of a sharded index belong to its shards and are not listed.
+    /// </summary>
+    DirectoryPtr openUnshardedIndexDirectory(
+        ThrowStatusWrapper* status,
+        const FtsConfig& ftsConfig,
+        const std::string& indexName,
+        const fs::path& indexDirectoryPath)
+    {
+        // the index directory exists, so the layout of the shards is found on disk
+        const auto shardPaths = getAllIndexShardPaths(indexDirectoryPath, 1, false);
+        if (shardPaths.size() != 1 || shardPaths.front() != indexDirectoryPath) {
+            throwException(status, R"(Index "%s" is sharded or partitioned. Its files and segments are not available.)", indexName.c_str());
+        }
+        return openIndexDirectory(status, ftsConfig, indexName, indexDirectoryPath);
+    }
+
+    /// <summary>
+    /// Opens a reader over all shards of a built index.
+    /// </summary>
+    IndexReaderPtr openBuiltIndexReader(
+        ThrowStatusWrapper* status,
+        const FtsConfig& ftsConfig,
+        const std::string& indexName,
+        const fs::path& indexDirectoryPath)
+    {
+        auto directories = Collection<DirectoryPtr>::newInstance();
+        for (const auto& shardPath : getAllIndexShardPaths(indexDirectoryPath, 1, false)) {
+            auto ftsIndexDir = openIndexDirectory(status, ftsConfig, indexName, shardPath);
+            if (!IndexReader::indexExists(ftsIndexDir)) {
+                throwException(status, R"(Index "%s" not build.)", indexName.c_str());
+            }
+            directories.add(ftsIndexDir);
+        }
+        return openIndexReader(directories);
+    }
+}
+
 /***
 FUNCTION FTS$LUCENE_VERSION ()
 RETURNS VARCHAR(20) CHARACTER SET UTF8
@@ -121,7 +164,8 @@ FB_UDR_BEGIN_PROCEDURE(getIndexStatistics)
         }
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto& ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -151,7 +195,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexStatistics)
             out->analyzerName.length = static_cast<ISC_USHORT>(ftsIndex.analyzer.length());
             ftsIndex.analyzer.copy(out->analyzerName.str, out->analyzerName.length);
 
-            const auto& indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto& indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
 
             const std::string indexDir = indexDirectoryPath.u8string();
             out->indexDirNull = false;
@@ -167,42 +211,61 @@ FB_UDR_BEGIN_PROCEDURE(getIndexStatistics)
                 out->indexExists = false;
             }
             else {
-                const auto& ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
-                if (!IndexReader::indexExists(ftsIndexDir)) {
-                    // index created, but not build
-                    ftsIndex.status = "N";
-                    out->indexExists = false;
-                }
-                else {
+                // the statistics of a sharded or partitioned index are summed over its shards
+                bool isOptimized = true;
+                bool hasDeletions = false;
+                int32_t numDocs = 0;
+                int32_t numDeletedDocs = 0;
+                int64_t indexSize = 0;
+                std::set<String> fieldNames;
+                for (const auto& shardPath : getAllIndexShardPaths(indexDirectoryPath, ftsIndex.shardCount, ftsIndex.isPartitioned())) {
+                    const auto& ftsIndexDir = openIndexDirectory(status, *ftsConfig, indexName, shardPath);
+                    if (!IndexReader::indexExists(ftsIndexDir)) {
+                        // index created, but not build
+                        ftsIndex.status = "N";
+                        out->indexExists = false;
+                        ftsIndexDir->close();
+                        break;
+                    }
                     const auto reader = IndexReader::open(ftsIndexDir, true);
                     LuceneFileHelper luceneFileHelper(ftsIndexDir);
 
+                    isOptimized = isOptimized && reader->isOptimized();
+                    hasDeletions = hasDeletions || reader->hasDeletions();
+                    numDocs += reader->numDocs();
+                    numDeletedDocs += reader->numDeletedDocs();
+
+                    //reader->getUniqueTermCount();
+
+                    for (const auto& fieldName : reader->getFieldNames(IndexReader::FIELD_OPTION_ALL)) {
+                        fieldNames.insert(fieldName);
+                    }
+
+                    // calculate index size
+                    indexSize += luceneFileHelper.getIndexSize();
+
+                    reader->close();
+                    ftsIndexDir->close();
+                }
+                if (out->indexExists) {
                     out->isOptimizedNull = false;
-                    out->isOptimized = reader->isOptimized();
+                    out->isOptimized = isOptimized;
 
                     out->hasDeletionsNull = false;
-                    out->hasDeletions = reader->hasDeletions();
+                    out->hasDeletions = hasDeletions;
 
                     out->numDocsNull = false;
-                    out->numDocs = reader->numDocs();
+                    out->numDocs = numDocs;
 
                     out->numDeletedDocsNull = false;
-                    out->numDeletedDocs = reader->numDeletedDocs();
-
-                    //reader->getUniqueTermCount();
+                    out->numDeletedDocs = numDeletedDocs;
 
                     out->numFieldsNull = false;
-                    auto fieldNames = reader->getFieldNames(IndexReader::FIELD_OPTION_ALL);
                     out->numFields = static_cast<ISC_SHORT>(fieldNames.size());
 
-
-                    // calculate index size
                     out->indexSizeNull = false;
-                    out->indexSize = luceneFileHelper.getIndexSize();
-
-                    reader->close();
+                    out->indexSize = indexSize;
                 }
-                ftsIndexDir->close();
             }
             out->indexStatusNull = false;
             out->indexStatus.length = static_cast<ISC_USHORT>(ftsIndex.status.length());
@@ -270,7 +333,8 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFields)
         }
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -290,25 +354,19 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFields)
             }
 
 
-            const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
 
             // Check if the index directory exists
             if (!fs::is_directory(indexDirectoryPath)) {
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            const auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
-            if (!IndexReader::indexExists(ftsIndexDir)) {
-                throwException(status, R"(Index "%s" not build.)", indexName.c_str());
-            }
-                
-            const auto reader = IndexReader::open(ftsIndexDir, true);
+            const auto reader = openBuiltIndexReader(status, *ftsConfig, indexName, indexDirectoryPath);
 
             fieldNames = reader->getFieldNames(IndexReader::FIELD_OPTION_ALL);
             it = fieldNames.begin();
 
             reader->close();
-            ftsIndexDir->close();
 
         }
         catch (const LuceneException& e) {
@@ -384,7 +442,8 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFiles)
         }
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto& ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -406,7 +465,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFiles)
             }
 
 
-            const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
 
             // Check if the index directory exists
             if (!fs::is_directory(indexDirectoryPath)) {
@@ -414,7 +473,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFiles)
             }
 
             const auto unicodeIndexDir = indexDirectoryPath.wstring();
-            const auto ftsIndexDir = FSDirectory::open(unicodeIndexDir);
+            const auto ftsIndexDir = openUnshardedIndexDirectory(status, *ftsConfig, indexName, indexDirectoryPath);
             luceneFileHelper.setDirectory(ftsIndexDir);
 
             auto allFileNames = ftsIndexDir->listAll();
@@ -516,7 +575,8 @@ FB_UDR_BEGIN_PROCEDURE(getIndexSegments)
         }
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto& ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -541,14 +601,14 @@ FB_UDR_BEGIN_PROCEDURE(getIndexSegments)
                 throwException(status, R"(Index "%s" not exists)", indexName.c_str());
             }
 
-            const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
 
             // Check if the index directory exists
             if (!fs::is_directory(indexDirectoryPath)) {
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
             
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            auto ftsIndexDir = openUnshardedIndexDirectory(status, *ftsConfig, indexName, indexDirectoryPath);
             segmentInfos = newLucene<SegmentInfos>();
             segmentInfos->read(ftsIndexDir);
             
@@ -675,7 +735,8 @@ FB_UDR_BEGIN_PROCEDURE(getFieldInfos)
             unicodeSegmentName = StringUtils::toUnicode(segmentName);
         }
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -693,14 +754,14 @@ FB_UDR_BEGIN_PROCEDURE(getFieldInfos)
                 throwException(status, R"(Index "%s" not exists)", indexName.c_str());
             }
 
-            const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
 
             // Check if the index directory exists
             if (!fs::is_directory(indexDirectoryPath)) {
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            auto ftsIndexDir = openUnshardedIndexDirectory(status, *ftsConfig, indexName, indexDirectoryPath);
             auto segmentInfos = newLucene<SegmentInfos>();
             segmentInfos->read(ftsIndexDir);
         
@@ -830,7 +891,8 @@ FB_UDR_BEGIN_PROCEDURE(indexTerms)
         }
         const std::string indexName(in->index_name.str, in->index_name.length);
 
-        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+        const auto ftsConfig = getFtsConfig(status, context);
+        const auto& ftsDirectoryPath = ftsConfig->ftsDirectory;
         // check if there is a directory for full-text indexes
         if (!fs::is_directory(ftsDirectoryPath)) {
             throwException(status, R"(Fts directory "%s" not exists)", ftsDirectoryPath.u8string().c_str());
@@ -842,13 +904,12 @@ FB_UDR_BEGIN_PROCEDURE(indexTerms)
             // get FTS index metadata
             auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
             // Check if the index directory exists. 
-            const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+            const auto indexDirectoryPath = getIndexGenerationPath(ftsDirectoryPath / indexName);
             if (!fs::is_directory(indexDirectoryPath)) {
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
-            auto reader = IndexReader::open(ftsIndexDir, true);
+            auto reader = openBuiltIndexReader(status, *ftsConfig, indexName, indexDirectoryPath);
             termIt = reader->terms();
             out->field_nameNull = true;
             out->termNull = true;
@@ -0,0 +1,51 @@
+/**
+ *  Collector that only counts matching documents.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "HitCountCollector.h"
+
+namespace Lucene 
+{
+
+    HitCountCollector::HitCountCollector()
+        : totalHits(0)
+    {
+    }
+
+    HitCountCollector::~HitCountCollector() {
+    }
+
+    int64_t HitCountCollector::getTotalHits() const
+    {
+        return totalHits;
+    }
+
+    void HitCountCollector::setScorer([[maybe_unused]] const ScorerPtr& scorer)
+    {
+        // scores are not needed
+    }
+
+    void HitCountCollector::collect([[maybe_unused]] int32_t doc)
+    {
+        ++totalHits;
+    }
+
+    void HitCountCollector::setNextReader([[maybe_unused]] const IndexReaderPtr& reader, [[maybe_unused]] int32_t docBase)
+    {
+    }
+
+    bool HitCountCollector::acceptsDocsOutOfOrder()
+    {
+        return true;
+    }
+
+}
@@ -0,0 +1,48 @@
+#ifndef HIT_COUNT_COLLECTOR_H
+#define HIT_COUNT_COLLECTOR_H
+
+/**
+ *  Collector that only counts matching documents.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Collector.h"
+
+namespace Lucene 
+{
+    /// Counts the documents matching a query. Scores are never computed, 
+    /// no priority queue is maintained and documents are accepted out of order.
+    class HitCountCollector : public Collector {
+    public:
+        HitCountCollector();
+
+        virtual ~HitCountCollector();
+
+        LUCENE_CLASS(HitCountCollector);
+
+    protected:
+        int64_t totalHits;
+
+    public:
+        /// Returns the number of documents collected.
+        int64_t getTotalHits() const;
+
+        virtual void setScorer(const ScorerPtr& scorer);
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+        virtual bool acceptsDocsOutOfOrder();
+    };
+
+    typedef boost::shared_ptr<HitCountCollector> HitCountCollectorPtr;
+}
+
+#endif // HIT_COUNT_COLLECTOR_H
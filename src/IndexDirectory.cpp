@@ -0,0 +1,771 @@
+/**
+ *  Opening the directories of full-text indexes.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "IndexDirectory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FBUtils.h"
+#include "FieldCache.h"
+#include "MMapDirectory.h"
+#include "RAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "Lock.h"
+#include "MultiReader.h"
+
+using namespace Firebird;
+using namespace Lucene;
+
+namespace
+{
+    const String WRITE_LOCK_FILE = L"write.lock";
+    const String SEGMENTS_FILE_PREFIX = L"segments";
+    const String SEGMENTS_GEN_FILE = L"segments.gen";
+
+    constexpr char SHARD_DIRECTORY_PREFIX[] = "shard_";
+    constexpr char PARTITION_DIRECTORY_PREFIX[] = "part_";
+    // the partitioning the index was built with, kept in the index directory next to the partitions
+    constexpr char PARTITIONING_FILE_NAME[] = "partitioning";
+    // the progress of a chunked rebuild, kept in the shadow directory
+    constexpr char REBUILD_CHECKPOINT_FILE_NAME[] = "rebuild.checkpoint";
+    // suffix of the directory next to the index directory where the index is rebuilt
+    constexpr char SHADOW_DIRECTORY_SUFFIX[] = ".new";
+    // a rebuilt index is moved into a generation subdirectory of the index directory, 
+    // the file current names the generation that is searched
+    constexpr char GENERATION_DIRECTORY_PREFIX[] = "gen_";
+    constexpr char CURRENT_GENERATION_FILE_NAME[] = "current";
+
+    fs::path getShardPath(const fs::path& indexDirectoryPath, size_t shard)
+    {
+        return indexDirectoryPath / (SHARD_DIRECTORY_PREFIX + std::to_string(shard));
+    }
+
+    std::vector<fs::path> getLayoutShardPaths(const fs::path& indexDirectoryPath, int shardCount)
+    {
+        std::vector<fs::path> shardPaths;
+        if (shardCount <= 1) {
+            shardPaths.push_back(indexDirectoryPath);
+            return shardPaths;
+        }
+        for (size_t shard = 0; shard < static_cast<size_t>(shardCount); ++shard) {
+            shardPaths.push_back(getShardPath(indexDirectoryPath, shard));
+        }
+        return shardPaths;
+    }
+
+    /// <summary>
+    /// Returns the shard directories found on disk, empty if the index directory holds no index.
+    /// </summary>
+    std::vector<fs::path> findShardPaths(const fs::path& indexDirectoryPath)
+    {
+        std::vector<fs::path> shardPaths;
+        if (!fs::is_directory(indexDirectoryPath)) {
+            return shardPaths;
+        }
+        for (size_t shard = 0; fs::is_directory(getShardPath(indexDirectoryPath, shard)); ++shard) {
+            shardPaths.push_back(getShardPath(indexDirectoryPath, shard));
+        }
+        if (!shardPaths.empty()) {
+            return shardPaths;
+        }
+        for (const auto& entry : fs::directory_iterator(indexDirectoryPath)) {
+            if (entry.is_regular_file()) {
+                shardPaths.push_back(indexDirectoryPath);
+                break;
+            }
+        }
+        return shardPaths;
+    }
+
+    /// <summary>
+    /// Returns the partition directories found on disk.
+    /// </summary>
+    std::vector<fs::path> findPartitionPaths(const fs::path& indexDirectoryPath)
+    {
+        std::vector<fs::path> partitionPaths;
+        if (!fs::is_directory(indexDirectoryPath)) {
+            return partitionPaths;
+        }
+        const std::string prefix(PARTITION_DIRECTORY_PREFIX);
+        for (const auto& entry : fs::directory_iterator(indexDirectoryPath)) {
+            if (entry.is_directory() && entry.path().filename().u8string().compare(0, prefix.length(), prefix) == 0) {
+                partitionPaths.push_back(entry.path());
+            }
+        }
+        std::sort(partitionPaths.begin(), partitionPaths.end());
+        return partitionPaths;
+    }
+
+    /// <summary>
+    /// Removes the contents of the index directory together with the copies of its resident indexes.
+    /// </summary>
+    bool clearIndexDirectory(const fs::path& indexDirectoryPath)
+    {
+        LuceneUDR::releaseIndexDirectory(indexDirectoryPath);
+        std::error_code ec;
+        std::vector<fs::path> entries;
+        for (const auto& entry : fs::directory_iterator(indexDirectoryPath, ec)) {
+            entries.push_back(entry.path());
+        }
+        for (const auto& entry : entries) {
+            fs::remove_all(entry, ec);
+            if (ec) {
+                return false;
+            }
+        }
+        return !ec;
+    }
+
+    constexpr int32_t COPY_BUFFER_SIZE = 64 * 1024;
+
+    /// <summary>
+    /// Copy of an index in memory shared by all connections of the process.
+    /// Closing it does nothing, since procedures close the directories they have opened.
+    /// </summary>
+    class ResidentDirectory : public RAMDirectory
+    {
+    public:
+        ResidentDirectory(const DirectoryPtr& dir)
+            : RAMDirectory(dir)
+        {}
+
+        LUCENE_CLASS(ResidentDirectory);
+
+    public:
+        virtual void close() {}
+
+        void release()
+        {
+            RAMDirectory::close();
+        }
+    };
+
+    using ResidentDirectoryPtr = boost::shared_ptr<ResidentDirectory>;
+
+    struct ResidentIndex
+    {
+        fs::path indexDirectoryPath;
+        ResidentDirectoryPtr directory;
+        // serializes persisting of the index
+        std::mutex mutex;
+        std::chrono::steady_clock::time_point persistedAt;
+        // there are commits not yet persisted to the index directory
+        std::atomic<bool> dirty{ false };
+    };
+
+    using ResidentIndexPtr = std::shared_ptr<ResidentIndex>;
+
+    void copyFile(const DirectoryPtr& source, const DirectoryPtr& dest, const String& fileName)
+    {
+        IndexInputPtr input = source->openInput(fileName);
+        IndexOutputPtr output = dest->createOutput(fileName);
+        ByteArray buffer(ByteArray::newInstance(COPY_BUFFER_SIZE));
+        int64_t remaining = input->length();
+        while (remaining > 0) {
+            const auto chunk = static_cast<int32_t>(std::min<int64_t>(remaining, COPY_BUFFER_SIZE));
+            input->readBytes(buffer.get(), 0, chunk);
+            output->writeBytes(buffer.get(), 0, chunk);
+            remaining -= chunk;
+        }
+        output->close();
+        input->close();
+        dest->sync(fileName);
+    }
+
+    /// <summary>
+    /// Writes the last commit of a resident index to the index directory.
+    /// Segment files are immutable, so only the new ones are copied. The segments files
+    /// are copied after them, therefore the index on disk always references complete files.
+    /// Finally the files of the previous commits are removed.
+    /// </summary>
+    void persistResidentIndex(ResidentIndex& index)
+    {
+        auto diskDir = FSDirectory::open(index.indexDirectoryPath.wstring());
+        const auto files = index.directory->listAll();
+        std::vector<String> segmentsFiles;
+        for (const auto& fileName : files) {
+            if (fileName == WRITE_LOCK_FILE) {
+                continue;
+            }
+            if (fileName.compare(0, SEGMENTS_FILE_PREFIX.length(), SEGMENTS_FILE_PREFIX) == 0) {
+                segmentsFiles.push_back(fileName);
+                continue;
+            }
+            if (diskDir->fileExists(fileName) && diskDir->fileLength(fileName) == index.directory->fileLength(fileName)) {
+                continue;
+            }
+            copyFile(index.directory, diskDir, fileName);
+        }
+        // segments.gen points to the current segments_N, so it goes last
+        std::sort(segmentsFiles.begin(), segmentsFiles.end(), [](const String& a, const String& b) {
+            return (a == SEGMENTS_GEN_FILE) < (b == SEGMENTS_GEN_FILE) || ((a == SEGMENTS_GEN_FILE) == (b == SEGMENTS_GEN_FILE) && a < b);
+        });
+        for (const auto& fileName : segmentsFiles) {
+            copyFile(index.directory, diskDir, fileName);
+        }
+        for (const auto& fileName : diskDir->listAll()) {
+            if (fileName == WRITE_LOCK_FILE || files.contains(fileName)) {
+                continue;
+            }
+            try {
+                diskDir->deleteFile(fileName);
+            }
+            catch (const LuceneException&) {
+                // the file is still open by a reader, it will be removed on the next persisting
+            }
+        }
+        diskDir->close();
+    }
+
+    class ResidentIndexes final
+    {
+    public:
+        ~ResidentIndexes()
+        {
+            // the module is unloaded, save what the persist interval has delayed
+            for (auto& [key, index] : m_indexes) {
+                try {
+                    if (index->dirty) {
+                        persistResidentIndex(*index);
+                    }
+                    index->directory->release();
+                }
+                catch (...) {
+                }
+            }
+        }
+
+        ResidentIndexPtr get(const fs::path& indexDirectoryPath)
+        {
+            const auto key = indexDirectoryPath.u8string();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_indexes.find(key);
+            if (it != m_indexes.end()) {
+                return it->second;
+            }
+            auto index = std::make_shared<ResidentIndex>();
+            index->indexDirectoryPath = indexDirectoryPath;
+            index->directory = newLucene<ResidentDirectory>(FSDirectory::open(indexDirectoryPath.wstring()));
+            index->persistedAt = std::chrono::steady_clock::now();
+            m_indexes.emplace(key, index);
+            return index;
+        }
+
+        void release(const fs::path& indexDirectoryPath)
+        {
+            // the shards and partitions of the index are in its subdirectories
+            const auto key = indexDirectoryPath.u8string();
+            const auto nestedPrefix = (indexDirectoryPath / "").u8string();
+            std::vector<ResidentIndexPtr> indexes;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto it = m_indexes.begin(); it != m_indexes.end();) {
+                    if (it->first == key || it->first.compare(0, nestedPrefix.length(), nestedPrefix) == 0) {
+                        indexes.push_back(it->second);
+                        it = m_indexes.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+            }
+            for (const auto& index : indexes) {
+                std::lock_guard<std::mutex> lock(index->mutex);
+                index->dirty = false;
+                index->directory->release();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::map<std::string, ResidentIndexPtr> m_indexes;
+    };
+
+    ResidentIndexes residentIndexes;
+
+    struct SharedReader
+    {
+        fs::path generationPath;
+        size_t directoryCount;
+        IndexReaderPtr reader;
+    };
+
+    /// <summary>
+    /// Readers kept open between calls, so that the field caches built over them are reused until the index changes.
+    /// </summary>
+    class SharedReaders final
+    {
+    public:
+        IndexReaderPtr get(const fs::path& indexDirectoryPath, const fs::path& generationPath, const Collection<DirectoryPtr>& directories)
+        {
+            const auto key = indexDirectoryPath.u8string();
+            IndexReaderPtr reader;
+            bool current = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_readers.find(key);
+                if (it != m_readers.end()) {
+                    reader = it->second.reader;
+                    current = it->second.generationPath == generationPath && it->second.directoryCount == directories.size();
+                }
+            }
+            // reading segments.gen is cheap compared to loading a field cache
+            if (current && isCurrent(reader)) {
+                return reader;
+            }
+
+            // opened without holding the lock, so other indexes are not blocked meanwhile
+            auto currentReader = LuceneUDR::openIndexReader(directories);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_readers.insert_or_assign(key, SharedReader{ generationPath, directories.size(), currentReader });
+            }
+            // the stale reader may still be searched by other connections, it is closed when they release it
+            if (reader) {
+                FieldCache::DEFAULT()->purge(reader);
+            }
+            return currentReader;
+        }
+
+        void release(const fs::path& indexDirectoryPath)
+        {
+            IndexReaderPtr reader;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_readers.find(indexDirectoryPath.u8string());
+                if (it == m_readers.end()) {
+                    return;
+                }
+                reader = it->second.reader;
+                m_readers.erase(it);
+            }
+            FieldCache::DEFAULT()->purge(reader);
+        }
+
+    private:
+        static bool isCurrent(const IndexReaderPtr& reader)
+        {
+            try {
+                return reader->isCurrent();
+            }
+            catch (const LuceneException&) {
+                // the shards of the index were removed or replaced
+                return false;
+            }
+        }
+
+        std::mutex m_mutex;
+        std::map<std::string, SharedReader> m_readers;
+    };
+
+    SharedReaders sharedReaders;
+
+    std::chrono::seconds getPersistInterval(ThrowStatusWrapper* status, const LuceneUDR::FtsConfig& config, std::string_view indexName)
+    {
+        const auto value = config.getOption(indexName, "persistInterval");
+        if (value.empty()) {
+            return std::chrono::seconds(0);
+        }
+        try {
+            const auto interval = std::stoll(value);
+            if (interval >= 0) {
+                return std::chrono::seconds(interval);
+            }
+        }
+        catch (const std::logic_error&) {
+        }
+        LuceneUDR::throwException(status, R"(Invalid value "%s" of option persistInterval. Expected a non-negative integer.)", value.c_str());
+        return std::chrono::seconds(0);
+    }
+
+    /// <summary>
+    /// Persists the resident index if it has unsaved commits and the persist interval has elapsed.
+    /// Called by the holder of the index writer, so no commit happens during copying 
+    /// and searches never wait for the disk.
+    /// </summary>
+    void persistIfDue(ResidentIndex& index, std::chrono::seconds interval)
+    {
+        std::lock_guard<std::mutex> guard(index.mutex);
+        const auto now = std::chrono::steady_clock::now();
+        if (!index.dirty || now - index.persistedAt < interval) {
+            return;
+        }
+        persistResidentIndex(index);
+        index.dirty = false;
+        index.persistedAt = now;
+    }
+}
+
+namespace LuceneUDR
+{
+
+    IndexDirectoryType getIndexDirectoryType(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName)
+    {
+        std::string value = config.getOption(indexName, "directoryType", "fs");
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        if (value == "fs") {
+            return IndexDirectoryType::FS;
+        }
+        if (value == "mmap") {
+            return IndexDirectoryType::MMAP;
+        }
+        if (value == "ram") {
+            return IndexDirectoryType::RAM;
+        }
+        throwException(status, R"(Invalid value "%s" of option directoryType. Expected fs, mmap or ram.)", value.c_str());
+        return IndexDirectoryType::FS;
+    }
+
+    DirectoryPtr openIndexDirectory(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName, const fs::path& indexDirectoryPath)
+    {
+        switch (getIndexDirectoryType(status, config, indexName)) {
+        case IndexDirectoryType::MMAP:
+            return newLucene<MMapDirectory>(indexDirectoryPath.wstring());
+        case IndexDirectoryType::RAM:
+            return residentIndexes.get(indexDirectoryPath)->directory;
+        default:
+            return FSDirectory::open(indexDirectoryPath.wstring());
+        }
+    }
+
+    DirectoryPtr openIndexWriterDirectory(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName, const fs::path& indexDirectoryPath)
+    {
+        if (getIndexDirectoryType(status, config, indexName) == IndexDirectoryType::RAM) {
+            return residentIndexes.get(indexDirectoryPath)->directory;
+        }
+        return FSDirectory::open(indexDirectoryPath.wstring());
+    }
+
+    void commitIndexDirectory(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName, const fs::path& indexDirectoryPath)
+    {
+        if (getIndexDirectoryType(status, config, indexName) != IndexDirectoryType::RAM) {
+            return;
+        }
+        const auto interval = getPersistInterval(status, config, indexName);
+        auto index = residentIndexes.get(indexDirectoryPath);
+        index->dirty = true;
+        persistIfDue(*index, interval);
+    }
+
+    void releaseIndexDirectory(const fs::path& indexDirectoryPath)
+    {
+        sharedReaders.release(indexDirectoryPath);
+        residentIndexes.release(indexDirectoryPath);
+    }
+
+    fs::path getShadowIndexDirectoryPath(const fs::path& indexDirectoryPath)
+    {
+        fs::path shadowDirectoryPath(indexDirectoryPath);
+        shadowDirectoryPath += SHADOW_DIRECTORY_SUFFIX;
+        return shadowDirectoryPath;
+    }
+
+    bool isIndexDirectoryLocked(const fs::path& indexDirectoryPath)
+    {
+        std::error_code ec;
+        if (!fs::is_directory(indexDirectoryPath, ec)) {
+            return false;
+        }
+        const std::string lockFileName = StringUtils::toUTF8(WRITE_LOCK_FILE);
+        for (const auto& entry : fs::recursive_directory_iterator(indexDirectoryPath, ec)) {
+            if (entry.path().filename().u8string() != lockFileName) {
+                continue;
+            }
+            // a lock file left by a crashed writer is not locked
+            if (IndexWriter::isLocked(FSDirectory::open(entry.path().parent_path().wstring()))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    fs::path getIndexGenerationPath(const fs::path& indexDirectoryPath)
+    {
+        std::ifstream file(indexDirectoryPath / CURRENT_GENERATION_FILE_NAME, std::ios::binary);
+        std::string generationName;
+        if (!std::getline(file, generationName) || generationName.empty()) {
+            // an index that has never been swapped is kept in the index directory itself
+            return indexDirectoryPath;
+        }
+        return indexDirectoryPath / generationName;
+    }
+
+    bool swapIndexDirectory(const fs::path& indexDirectoryPath, const fs::path& shadowDirectoryPath)
+    {
+        std::error_code ec;
+        removeReplacedIndexDirectories(indexDirectoryPath);
+        fs::create_directories(indexDirectoryPath, ec);
+        const auto replacedGenerationPath = getIndexGenerationPath(indexDirectoryPath);
+
+        // generations are numbered upwards, so that a name is never reused while the old files may still be open
+        const std::string prefix = GENERATION_DIRECTORY_PREFIX;
+        unsigned long generation = 0;
+        for (const auto& entry : fs::directory_iterator(indexDirectoryPath, ec)) {
+            const auto name = entry.path().filename().u8string();
+            if (name.compare(0, prefix.length(), prefix) == 0) {
+                generation = std::max(generation, std::strtoul(name.c_str() + prefix.length(), nullptr, 10) + 1);
+            }
+        }
+        const std::string generationName = prefix + std::to_string(generation);
+        const auto generationPath = indexDirectoryPath / generationName;
+
+        // Nothing has the files of the rebuilt index open, so the directory can be moved on all systems. 
+        // The current index is not renamed, readers keep using it until the pointer file is replaced.
+        fs::rename(shadowDirectoryPath, generationPath, ec);
+        if (ec) {
+            return false;
+        }
+        const auto pointerPath = indexDirectoryPath / CURRENT_GENERATION_FILE_NAME;
+        auto tempPath = pointerPath;
+        tempPath += ".tmp";
+        bool written = false;
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file << generationName << '\n';
+            file.flush();
+            written = static_cast<bool>(file);
+        }
+        // replacing the pointer file switches all new readers to the rebuilt index at once
+        if (written) {
+            fs::rename(tempPath, pointerPath, ec);
+        }
+        if (!written || ec) {
+            fs::remove(tempPath, ec);
+            fs::rename(generationPath, shadowDirectoryPath, ec);
+            return false;
+        }
+        sharedReaders.release(indexDirectoryPath);
+        residentIndexes.release(replacedGenerationPath);
+        removeReplacedIndexDirectories(indexDirectoryPath);
+        return true;
+    }
+
+    void removeReplacedIndexDirectories(const fs::path& indexDirectoryPath)
+    {
+        std::error_code ec;
+        const auto generationPath = getIndexGenerationPath(indexDirectoryPath);
+        if (generationPath == indexDirectoryPath) {
+            return;
+        }
+        // older generations, and the files of the index from before its first swap
+        std::vector<fs::path> replacedPaths;
+        for (const auto& entry : fs::directory_iterator(indexDirectoryPath, ec)) {
+            const auto name = entry.path().filename().u8string();
+            if (entry.path() != generationPath && name != CURRENT_GENERATION_FILE_NAME) {
+                replacedPaths.push_back(entry.path());
+            }
+        }
+        for (const auto& replacedPath : replacedPaths) {
+            // files still open by readers cannot be removed on some systems, the rest is removed next time
+            fs::remove_all(replacedPath, ec);
+        }
+    }
+
+    std::vector<fs::path> getIndexShardPaths(const fs::path& indexDirectoryPath, int shardCount)
+    {
+        auto shardPaths = findShardPaths(indexDirectoryPath);
+        if (shardPaths.empty()) {
+            return getLayoutShardPaths(indexDirectoryPath, shardCount);
+        }
+        return shardPaths;
+    }
+
+    bool prepareIndexLayout(const fs::path& indexDirectoryPath, int shardCount, std::string_view partitioning)
+    {
+        if (fs::is_directory(indexDirectoryPath)) {
+            bool keepLayout = false;
+            if (partitioning.empty() && !isIndexPartitioned(indexDirectoryPath, false)) {
+                const auto shardPaths = findShardPaths(indexDirectoryPath);
+                keepLayout = shardPaths.empty() || shardPaths == getLayoutShardPaths(indexDirectoryPath, shardCount);
+            }
+            // partitions of values that no longer exist must not survive the rebuild
+            if (!keepLayout && !clearIndexDirectory(indexDirectoryPath)) {
+                return false;
+            }
+        }
+        if (partitioning.empty()) {
+            return true;
+        }
+        std::error_code ec;
+        fs::create_directories(indexDirectoryPath, ec);
+        std::ofstream file(indexDirectoryPath / PARTITIONING_FILE_NAME, std::ios::binary | std::ios::trunc);
+        file << partitioning;
+        return static_cast<bool>(file);
+    }
+
+    std::optional<std::string> getIndexPartitioning(const fs::path& indexDirectoryPath)
+    {
+        std::ifstream file(indexDirectoryPath / PARTITIONING_FILE_NAME, std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    bool writeRebuildCheckpoint(const fs::path& shadowDirectoryPath, const RebuildCheckpoint& checkpoint)
+    {
+        // the previous checkpoint is replaced at once, so that a failure leaves one of them
+        const auto checkpointPath = shadowDirectoryPath / REBUILD_CHECKPOINT_FILE_NAME;
+        auto tempPath = checkpointPath;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file << checkpoint.shardCount << '\n' << checkpoint.lastKey;
+            file.flush();
+            if (!file) {
+                return false;
+            }
+        }
+        std::error_code ec;
+        fs::rename(tempPath, checkpointPath, ec);
+        return !ec;
+    }
+
+    std::optional<RebuildCheckpoint> readRebuildCheckpoint(const fs::path& shadowDirectoryPath)
+    {
+        std::ifstream file(shadowDirectoryPath / REBUILD_CHECKPOINT_FILE_NAME, std::ios::binary);
+        RebuildCheckpoint checkpoint;
+        if (!(file >> checkpoint.shardCount) || file.get() != '\n' || !std::getline(file, checkpoint.lastKey) || checkpoint.lastKey.empty()) {
+            return std::nullopt;
+        }
+        return checkpoint;
+    }
+
+    bool removeRebuildCheckpoint(const fs::path& shadowDirectoryPath)
+    {
+        std::error_code ec;
+        fs::remove(shadowDirectoryPath / REBUILD_CHECKPOINT_FILE_NAME, ec);
+        return !ec;
+    }
+
+    std::string getMonthPartitionValue(ThrowStatusWrapper* status, std::string_view dateValue)
+    {
+        if (dateValue.empty()) {
+            return {};
+        }
+        // dates are read as text in the format YYYY-MM-DD, the month partition is named YYYY-MM
+        const auto isDigits = [dateValue](size_t pos, size_t count) {
+            return std::all_of(dateValue.cbegin() + pos, dateValue.cbegin() + pos + count, [](char c) { return c >= '0' && c <= '9'; });
+        };
+        if (dateValue.length() < 7 || !isDigits(0, 4) || dateValue[4] != '-' || !isDigits(5, 2)) {
+            const std::string sDateValue(dateValue);
+            throwException(status, R"(Value "%s" of the partition field is not a date.)", sDateValue.c_str());
+        }
+        return std::string(dateValue.substr(0, 7));
+    }
+
+    fs::path getIndexPartitionPath(const fs::path& indexDirectoryPath, std::string_view partitionValue)
+    {
+        // Letters are escaped in upper case only, so that names do not collide on case-insensitive file systems.
+        static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+        // values of CHAR fields are compared without trailing spaces, as in SQL
+        const auto length = partitionValue.find_last_not_of(' ');
+        partitionValue = partitionValue.substr(0, length == std::string_view::npos ? 0 : length + 1);
+        std::string name(PARTITION_DIRECTORY_PREFIX);
+        for (const unsigned char c : partitionValue) {
+            if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.') {
+                name += static_cast<char>(c);
+            }
+            else {
+                name += '%';
+                name += HEX_DIGITS[c >> 4];
+                name += HEX_DIGITS[c & 0x0F];
+            }
+        }
+        return indexDirectoryPath / fs::u8path(name);
+    }
+
+    std::vector<fs::path> getIndexPartitionPaths(const fs::path& indexDirectoryPath)
+    {
+        return findPartitionPaths(indexDirectoryPath);
+    }
+
+    bool isIndexPartitioned(const fs::path& indexDirectoryPath, bool partitioned)
+    {
+        if (fs::is_regular_file(indexDirectoryPath / PARTITIONING_FILE_NAME) || !findPartitionPaths(indexDirectoryPath).empty()) {
+            return true;
+        }
+        if (!findShardPaths(indexDirectoryPath).empty()) {
+            return false;
+        }
+        return partitioned;
+    }
+
+    std::vector<fs::path> getAllIndexShardPaths(const fs::path& indexDirectoryPath, int shardCount, bool partitioned)
+    {
+        if (!isIndexPartitioned(indexDirectoryPath, partitioned)) {
+            return getIndexShardPaths(indexDirectoryPath, shardCount);
+        }
+        std::vector<fs::path> shardPaths;
+        for (const auto& partitionPath : findPartitionPaths(indexDirectoryPath)) {
+            const auto partitionShardPaths = getIndexShardPaths(partitionPath, shardCount);
+            shardPaths.insert(shardPaths.end(), partitionShardPaths.cbegin(), partitionShardPaths.cend());
+        }
+        return shardPaths;
+    }
+
+    bool isIndexOptimized(
+        ThrowStatusWrapper* status,
+        const FtsConfig& config,
+        std::string_view indexName,
+        const fs::path& indexDirectoryPath)
+    {
+        auto directory = openIndexDirectory(status, config, indexName, indexDirectoryPath);
+        if (!IndexReader::indexExists(directory)) {
+            return false;
+        }
+        auto reader = IndexReader::open(directory, true);
+        const bool optimized = reader->isOptimized();
+        reader->close();
+        return optimized;
+    }
+
+    size_t getIndexShard(const String& keyValue, size_t shardCount)
+    {
+        // FNV-1a over the UTF-8 representation of the key
+        const std::string key = StringUtils::toUTF8(keyValue);
+        uint64_t hash = 14695981039346656037ULL;
+        for (const unsigned char c : key) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash % shardCount);
+    }
+
+    IndexReaderPtr openIndexReader(const Collection<DirectoryPtr>& directories)
+    {
+        if (directories.size() == 1) {
+            return IndexReader::open(directories[0], true);
+        }
+        auto readers = Collection<IndexReaderPtr>::newInstance();
+        for (const auto& directory : directories) {
+            readers.add(IndexReader::open(directory, true));
+        }
+        return newLucene<MultiReader>(readers);
+    }
+
+    IndexReaderPtr openSharedIndexReader(const fs::path& indexDirectoryPath, const fs::path& generationPath, const Collection<DirectoryPtr>& directories)
+    {
+        return sharedReaders.get(indexDirectoryPath, generationPath, directories);
+    }
+}
@@ -0,0 +1,344 @@
+#ifndef INDEX_DIRECTORY_H
+#define INDEX_DIRECTORY_H
+
+/**
+ *  Opening the directories of full-text indexes.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LuceneUdr.h"
+#include "LuceneHeaders.h"
+#include "FTSUtils.h"
+
+namespace LuceneUDR
+{
+    /// <summary>
+    /// Implementation of the Lucene directory used to read an index.
+    /// </summary>
+    enum class IndexDirectoryType
+    {
+        // buffered reads through FSDirectory::open
+        FS,
+        // files are mapped into memory, readers share the pages of the OS cache
+        MMAP,
+        // the index is loaded into memory once, searched and updated there
+        // and persisted to the index directory
+        RAM
+    };
+
+    /// <summary>
+    /// Returns the directory type of the index from the option directoryType (fs, mmap or ram).
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    ///
+    /// <returns>Directory type</returns>
+    IndexDirectoryType getIndexDirectoryType(Firebird::ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName);
+
+    /// <summary>
+    /// Opens the directory of the index for reading with the implementation selected by the option directoryType.
+    /// A resident index is loaded into memory on first use and shared by all connections of the process.
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Lucene directory</returns>
+    Lucene::DirectoryPtr openIndexDirectory(
+        Firebird::ThrowStatusWrapper* status,
+        const FtsConfig& config,
+        std::string_view indexName,
+        const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Opens the directory of the index for writing.
+    /// Writers of a resident index change its copy in memory, other indexes are written to disk.
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Lucene directory</returns>
+    Lucene::DirectoryPtr openIndexWriterDirectory(
+        Firebird::ThrowStatusWrapper* status,
+        const FtsConfig& config,
+        std::string_view indexName,
+        const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Must be called by the holder of the index writer after each commit.
+    /// Persists a resident index to the index directory, at most once per persistInterval seconds.
+    /// Does nothing for other indexes.
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    void commitIndexDirectory(
+        Firebird::ThrowStatusWrapper* status,
+        const FtsConfig& config,
+        std::string_view indexName,
+        const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Discards the copies in memory of the resident indexes in the directory and its subdirectories without persisting them, 
+    /// and the shared reader of the index. Used when the index is dropped.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    void releaseIndexDirectory(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Returns the directory <index>.new next to the index directory, where the index is rebuilt 
+    /// while searches keep using the current one.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Path to the shadow directory</returns>
+    fs::path getShadowIndexDirectoryPath(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Checks whether an index writer holds a lock in the directory or its subdirectories.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>true if the directory is being written</returns>
+    bool isIndexDirectoryLocked(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Returns the directory holding the files of the index that are searched and updated: 
+    /// the generation subdirectory named by the file current of the index directory, 
+    /// or the index directory itself if the index has never been swapped.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Path to the current generation of the index</returns>
+    fs::path getIndexGenerationPath(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Replaces the index with the rebuilt shadow directory. The shadow directory is moved into a new generation 
+    /// subdirectory gen_N of the index directory, then the file current is atomically replaced to point to it. 
+    /// The directory of the current index is never renamed, so open readers do not prevent the swap on any system 
+    /// and searches always find an index. Readers opened before the swap keep using the replaced generation; 
+    /// it is removed as far as its files are no longer open, the rest by a later swap or by dropping the index.
+    /// Shared readers and copies in memory of a resident index are discarded and loaded again from the new files.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="shadowDirectoryPath">Path to the shadow directory</param>
+    ///
+    /// <returns>false if the swap failed, the current index is then kept</returns>
+    bool swapIndexDirectory(const fs::path& indexDirectoryPath, const fs::path& shadowDirectoryPath);
+
+    /// <summary>
+    /// Removes the generations of the index replaced by previous swaps, and the files of the index 
+    /// from before its first swap, as far as they are no longer open.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    void removeReplacedIndexDirectories(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Returns the directories of the index shards. An index without shards is kept in the index directory itself, 
+    /// the shards of a sharded index in its subdirectories shard_0 ... shard_N-1.
+    /// The layout found on disk takes precedence, so that an index keeps working with its shards 
+    /// until it is rebuilt after a change of their number.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="shardCount">Number of shards from the index metadata, used if the index is not built yet</param>
+    ///
+    /// <returns>Paths to the shard directories</returns>
+    std::vector<fs::path> getIndexShardPaths(const fs::path& indexDirectoryPath, int shardCount);
+
+    /// <summary>
+    /// Prepares the index directory for a rebuild with the given number of shards and partitioning.
+    /// If the layout on disk differs, the contents of the directory are removed. 
+    /// The partitions of a partitioned index are always removed, since they are all written again, 
+    /// and the partitioning is stored in the index directory.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="shardCount">Number of shards</param>
+    /// <param name="partitioning">Description of the partitioning, empty if the index is not partitioned</param>
+    ///
+    /// <returns>false if the old layout cannot be removed</returns>
+    bool prepareIndexLayout(const fs::path& indexDirectoryPath, int shardCount, std::string_view partitioning);
+
+    /// <summary>
+    /// Returns the partitioning the index was built with.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Description of the partitioning or nothing if it is not stored</returns>
+    std::optional<std::string> getIndexPartitioning(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Progress of a chunked rebuild: the records up to the last key are committed to the shadow directory.
+    /// </summary>
+    struct RebuildCheckpoint
+    {
+        int shardCount = 1;
+        std::string lastKey;
+    };
+
+    /// <summary>
+    /// Stores the checkpoint of a chunked rebuild in the shadow directory. 
+    /// Must be called after the chunks up to the last key are committed to the index.
+    /// </summary>
+    ///
+    /// <param name="shadowDirectoryPath">Path to the shadow directory</param>
+    /// <param name="checkpoint">Checkpoint</param>
+    ///
+    /// <returns>false if the checkpoint cannot be written</returns>
+    bool writeRebuildCheckpoint(const fs::path& shadowDirectoryPath, const RebuildCheckpoint& checkpoint);
+
+    /// <summary>
+    /// Returns the checkpoint of an interrupted chunked rebuild.
+    /// </summary>
+    ///
+    /// <param name="shadowDirectoryPath">Path to the shadow directory</param>
+    ///
+    /// <returns>Checkpoint or nothing if no chunk was committed</returns>
+    std::optional<RebuildCheckpoint> readRebuildCheckpoint(const fs::path& shadowDirectoryPath);
+
+    /// <summary>
+    /// Removes the checkpoint of a completed rebuild before the shadow directory is swapped in.
+    /// </summary>
+    ///
+    /// <param name="shadowDirectoryPath">Path to the shadow directory</param>
+    ///
+    /// <returns>false if the checkpoint cannot be removed</returns>
+    bool removeRebuildCheckpoint(const fs::path& shadowDirectoryPath);
+
+    /// <summary>
+    /// Returns the partition value YYYY-MM of an index partitioned by month. 
+    /// Partition directories of months sort in chronological order.
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="dateValue">Value of the date field as text, empty for NULL</param>
+    ///
+    /// <returns>Month of the date, empty for NULL</returns>
+    std::string getMonthPartitionValue(Firebird::ThrowStatusWrapper* status, std::string_view dateValue);
+
+    /// <summary>
+    /// Returns the directory of the partition with the given value of the partition field. 
+    /// The partition directories part_* are in the index directory, and each of them holds the shards of its partition.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="partitionValue">Value of the partition field</param>
+    ///
+    /// <returns>Path to the partition directory</returns>
+    fs::path getIndexPartitionPath(const fs::path& indexDirectoryPath, std::string_view partitionValue);
+
+    /// <summary>
+    /// Returns the directories of all partitions of the index found on disk in the order of their names.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    ///
+    /// <returns>Paths to the partition directories</returns>
+    std::vector<fs::path> getIndexPartitionPaths(const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Returns whether the index is partitioned. As for the shards, the layout found on disk takes precedence.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="partitioned">The index metadata has a partition field, used if the index is not built yet</param>
+    ///
+    /// <returns>true if the documents are in the partition directories</returns>
+    bool isIndexPartitioned(const fs::path& indexDirectoryPath, bool partitioned);
+
+    /// <summary>
+    /// Returns the directories of all shards of all partitions of the index.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory</param>
+    /// <param name="shardCount">Number of shards from the index metadata</param>
+    /// <param name="partitioned">The index metadata has a partition field</param>
+    ///
+    /// <returns>Paths to the shard directories</returns>
+    std::vector<fs::path> getAllIndexShardPaths(const fs::path& indexDirectoryPath, int shardCount, bool partitioned);
+
+    /// <summary>
+    /// Checks whether the index in the directory consists of one segment without deletions, 
+    /// so that optimizing it would only rewrite the same documents.
+    /// </summary>
+    ///
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="indexDirectoryPath">Path to the index or shard directory</param>
+    ///
+    /// <returns>true if the index is optimized</returns>
+    bool isIndexOptimized(
+        Firebird::ThrowStatusWrapper* status,
+        const FtsConfig& config,
+        std::string_view indexName,
+        const fs::path& indexDirectoryPath);
+
+    /// <summary>
+    /// Returns the shard holding the document with the given key value. 
+    /// The hash does not depend on the platform, so documents keep their shards.
+    /// </summary>
+    ///
+    /// <param name="keyValue">Value of the key field as it is indexed</param>
+    /// <param name="shardCount">Number of shards</param>
+    ///
+    /// <returns>Shard number</returns>
+    size_t getIndexShard(const Lucene::String& keyValue, size_t shardCount);
+
+    /// <summary>
+    /// Opens a reader over the directories of all shards of an index.
+    /// </summary>
+    ///
+    /// <param name="directories">Shard directories</param>
+    ///
+    /// <returns>Index reader, a MultiReader for several shards</returns>
+    Lucene::IndexReaderPtr openIndexReader(const Lucene::Collection<Lucene::DirectoryPtr>& directories);
+
+    /// <summary>
+    /// Returns a reader over the directories of all shards of an index shared by all connections. 
+    /// The reader is kept open until the index changes, so the field caches loaded for it are reused. 
+    /// It must not be closed by the caller.
+    /// </summary>
+    ///
+    /// <param name="indexDirectoryPath">Path to the index directory, the cache key</param>
+    /// <param name="generationPath">Generation of the index resolved before the directories were opened</param>
+    /// <param name="directories">Shard directories</param>
+    ///
+    /// <returns>Index reader, a MultiReader for several shards</returns>
+    Lucene::IndexReaderPtr openSharedIndexReader(
+        const fs::path& indexDirectoryPath,
+        const fs::path& generationPath,
+        const Lucene::Collection<Lucene::DirectoryPtr>& directories);
+}
+
+#endif // INDEX_DIRECTORY_H
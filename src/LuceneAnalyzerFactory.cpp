@@ -11,7 +11,9 @@
  *  Contributor(s): ______________________________________.
 **/
 
-#include <functional>
+#include <array>
+#include <cstdint>
+#include <mutex>
 #include <stdexcept>
 
 #include "ArabicAnalyzer.h"
@@ -26,6 +28,7 @@
 #include "GermanAnalyzer.h"
 #include "GreekAnalyzer.h"
 #include "LuceneAnalyzerFactory.h"
+#include "NGramAnalyzer.h"
 #include "PersianAnalyzer.h"
 #include "RussianAnalyzer.h"
 #include "SnowballAnalyzer.h"
@@ -34,390 +37,499 @@
 using namespace Firebird;
 using namespace Lucene;
 
-namespace LuceneUDR 
-{
+namespace {
 
-    LuceneAnalyzerFactory::LuceneAnalyzerFactory()
-        : m_factories
-        {
-            {
-                "STANDARD",
-                {
-                    []() -> AnalyzerPtr { return newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return StopAnalyzer::ENGLISH_STOP_WORDS_SET(); },
-                    true
-                }
-            },
-            {
-                "SIMPLE",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SimpleAnalyzer>(); },
-                    []([[maybe_unused]] const HashSet<String> stopWords) -> AnalyzerPtr { return nullptr; },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    false
-                }
-            },
-            {
-                "WHITESPACE",
-                {
-                    []() -> AnalyzerPtr { return newLucene<WhitespaceAnalyzer>(); },
-                    []([[maybe_unused]] const HashSet<String> stopWords) -> AnalyzerPtr { return nullptr; },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    false
-                }
-            },
-            {
-                "KEYWORD",
-                {
-                    []() -> AnalyzerPtr { return newLucene<KeywordAnalyzer>(); },
-                    []([[maybe_unused]] const HashSet<String> stopWords) -> AnalyzerPtr { return nullptr; },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    false
-                }
-            },
-            {
-                "STOP",
-                {
-                    []() -> AnalyzerPtr { return newLucene<StopAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<StopAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return StopAnalyzer::ENGLISH_STOP_WORDS_SET(); },
-                    true
-                }
-            },
-            {
-                "ARABIC",
-                {
-                    []() -> AnalyzerPtr { return newLucene<ArabicAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<ArabicAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return ArabicAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "BRAZILIAN",
-                {
-                    []() -> AnalyzerPtr { return newLucene<BrazilianAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<BrazilianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return BrazilianAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "CHINESE",
-                {
-                    []() -> AnalyzerPtr { return newLucene<ChineseAnalyzer>(); },
-                    []([[maybe_unused]] const HashSet<String> stopWords) -> AnalyzerPtr { return nullptr; },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    false
-                }
-            },
-            {
-                "CJK",
-                {
-                    []() -> AnalyzerPtr { return newLucene<CJKAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<CJKAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return CJKAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "CZECH",
-                {
-                    []() -> AnalyzerPtr { return newLucene<CzechAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<CzechAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return CzechAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "DUTCH",
-                {
-                    []() -> AnalyzerPtr { return newLucene<DutchAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<DutchAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return DutchAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "ENGLISH",
-                {
-                    []() -> AnalyzerPtr { return newLucene<EnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<EnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return EnglishAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "FRENCH",
-                {
-                    []() -> AnalyzerPtr { return newLucene<FrenchAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<FrenchAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return FrenchAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "GERMAN",
-                {
-                    []() -> AnalyzerPtr { return newLucene<GermanAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<GermanAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return GermanAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "GREEK",
-                {
-                    []() -> AnalyzerPtr { return newLucene<GreekAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<GreekAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return GreekAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "PERSIAN",
-                {
-                    []() -> AnalyzerPtr { return newLucene<PersianAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<PersianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return PersianAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "RUSSIAN",
-                {
-                    []() -> AnalyzerPtr { return newLucene<RussianAnalyzer>(LuceneVersion::LUCENE_CURRENT); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<RussianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords); },
-                    []() -> HashSet<String> { return RussianAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(DANISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"danish"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"danish", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(DUTCH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"dutch", DutchAnalyzer::getDefaultStopSet()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"dutch", stopWords); },
-                    []() -> HashSet<String> { return DutchAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(ENGLISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"english", StopAnalyzer::ENGLISH_STOP_WORDS_SET()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"english", stopWords); },
-                    []() -> HashSet<String> { return StopAnalyzer::ENGLISH_STOP_WORDS_SET(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(FINNISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"finnish"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"finnish", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(FRENCH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"french", FrenchAnalyzer::getDefaultStopSet()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"french", stopWords); },
-                    []() -> HashSet<String> { return FrenchAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(GERMAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"german", GermanAnalyzer::getDefaultStopSet()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"german", stopWords); },
-                    []() -> HashSet<String> { return GermanAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(HUNGARIAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"hungarian"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"hungarian", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(ITALIAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"italian"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"italian", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(NORWEGIAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"norwegian"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"norwegian", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(PORTER)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"porter", StopAnalyzer::ENGLISH_STOP_WORDS_SET()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"porter", stopWords); },
-                    []() -> HashSet<String> { return StopAnalyzer::ENGLISH_STOP_WORDS_SET(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(PORTUGUESE)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"portuguese"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"portuguese", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(ROMANIAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"romanian"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"romanian", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(RUSSIAN)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"russian", RussianAnalyzer::getDefaultStopSet()); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"russian", stopWords); },
-                    []() -> HashSet<String> { return RussianAnalyzer::getDefaultStopSet(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(SPANISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"spanish"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"spanish", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(SWEDISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"swedish"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"swedish", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
-            },
-            {
-                "SNOWBALL(TURKISH)",
-                {
-                    []() -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"turkish"); },
-                    [](const HashSet<String> stopWords) -> AnalyzerPtr { return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, L"turkish", stopWords); },
-                    []() -> HashSet<String> { return HashSet<String>::newInstance(); },
-                    true
-                }
+    // System analyzers. The order matches SYSTEM_ANALYZERS.
+    enum class SystemAnalyzer : uint8_t
+    {
+        ARABIC,
+        BRAZILIAN,
+        CHINESE,
+        CJK,
+        CZECH,
+        DUTCH,
+        EDGE_NGRAM,
+        ENGLISH,
+        FRENCH,
+        GERMAN,
+        GREEK,
+        KEYWORD,
+        NGRAM,
+        PERSIAN,
+        RUSSIAN,
+        SIMPLE,
+        SNOWBALL_DANISH,
+        SNOWBALL_DUTCH,
+        SNOWBALL_ENGLISH,
+        SNOWBALL_FINNISH,
+        SNOWBALL_FRENCH,
+        SNOWBALL_GERMAN,
+        SNOWBALL_HUNGARIAN,
+        SNOWBALL_ITALIAN,
+        SNOWBALL_NORWEGIAN,
+        SNOWBALL_PORTER,
+        SNOWBALL_PORTUGUESE,
+        SNOWBALL_ROMANIAN,
+        SNOWBALL_RUSSIAN,
+        SNOWBALL_SPANISH,
+        SNOWBALL_SWEDISH,
+        SNOWBALL_TURKISH,
+        STANDARD,
+        STOP,
+        WHITESPACE
+    };
+
+    struct SystemAnalyzerInfo
+    {
+        std::string_view name;
+        SystemAnalyzer kind;
+        bool stopWordsSupported;
+        // language of the snowball stemmer, nullptr for other analyzers
+        const wchar_t* snowballLanguage;
+    };
+
+    // Sorted by name, so that the list of analyzers is returned in alphabetical order.
+    constexpr std::array SYSTEM_ANALYZERS {
+        SystemAnalyzerInfo{ "ARABIC",               SystemAnalyzer::ARABIC,              true,  nullptr },
+        SystemAnalyzerInfo{ "BRAZILIAN",            SystemAnalyzer::BRAZILIAN,           true,  nullptr },
+        SystemAnalyzerInfo{ "CHINESE",              SystemAnalyzer::CHINESE,             false, nullptr },
+        SystemAnalyzerInfo{ "CJK",                  SystemAnalyzer::CJK,                 true,  nullptr },
+        SystemAnalyzerInfo{ "CZECH",                SystemAnalyzer::CZECH,               true,  nullptr },
+        SystemAnalyzerInfo{ "DUTCH",                SystemAnalyzer::DUTCH,               true,  nullptr },
+        SystemAnalyzerInfo{ "EDGE_NGRAM",           SystemAnalyzer::EDGE_NGRAM,          true,  nullptr },
+        SystemAnalyzerInfo{ "ENGLISH",              SystemAnalyzer::ENGLISH,             true,  nullptr },
+        SystemAnalyzerInfo{ "FRENCH",               SystemAnalyzer::FRENCH,              true,  nullptr },
+        SystemAnalyzerInfo{ "GERMAN",               SystemAnalyzer::GERMAN,              true,  nullptr },
+        SystemAnalyzerInfo{ "GREEK",                SystemAnalyzer::GREEK,               true,  nullptr },
+        SystemAnalyzerInfo{ "KEYWORD",              SystemAnalyzer::KEYWORD,             false, nullptr },
+        SystemAnalyzerInfo{ "NGRAM",                SystemAnalyzer::NGRAM,               true,  nullptr },
+        SystemAnalyzerInfo{ "PERSIAN",              SystemAnalyzer::PERSIAN,             true,  nullptr },
+        SystemAnalyzerInfo{ "RUSSIAN",              SystemAnalyzer::RUSSIAN,             true,  nullptr },
+        SystemAnalyzerInfo{ "SIMPLE",               SystemAnalyzer::SIMPLE,              false, nullptr },
+        SystemAnalyzerInfo{ "SNOWBALL(DANISH)",     SystemAnalyzer::SNOWBALL_DANISH,     true,  L"danish" },
+        SystemAnalyzerInfo{ "SNOWBALL(DUTCH)",      SystemAnalyzer::SNOWBALL_DUTCH,      true,  L"dutch" },
+        SystemAnalyzerInfo{ "SNOWBALL(ENGLISH)",    SystemAnalyzer::SNOWBALL_ENGLISH,    true,  L"english" },
+        SystemAnalyzerInfo{ "SNOWBALL(FINNISH)",    SystemAnalyzer::SNOWBALL_FINNISH,    true,  L"finnish" },
+        SystemAnalyzerInfo{ "SNOWBALL(FRENCH)",     SystemAnalyzer::SNOWBALL_FRENCH,     true,  L"french" },
+        SystemAnalyzerInfo{ "SNOWBALL(GERMAN)",     SystemAnalyzer::SNOWBALL_GERMAN,     true,  L"german" },
+        SystemAnalyzerInfo{ "SNOWBALL(HUNGARIAN)",  SystemAnalyzer::SNOWBALL_HUNGARIAN,  true,  L"hungarian" },
+        SystemAnalyzerInfo{ "SNOWBALL(ITALIAN)",    SystemAnalyzer::SNOWBALL_ITALIAN,    true,  L"italian" },
+        SystemAnalyzerInfo{ "SNOWBALL(NORWEGIAN)",  SystemAnalyzer::SNOWBALL_NORWEGIAN,  true,  L"norwegian" },
+        SystemAnalyzerInfo{ "SNOWBALL(PORTER)",     SystemAnalyzer::SNOWBALL_PORTER,     true,  L"porter" },
+        SystemAnalyzerInfo{ "SNOWBALL(PORTUGUESE)", SystemAnalyzer::SNOWBALL_PORTUGUESE, true,  L"portuguese" },
+        SystemAnalyzerInfo{ "SNOWBALL(ROMANIAN)",   SystemAnalyzer::SNOWBALL_ROMANIAN,   true,  L"romanian" },
+        SystemAnalyzerInfo{ "SNOWBALL(RUSSIAN)",    SystemAnalyzer::SNOWBALL_RUSSIAN,    true,  L"russian" },
+        SystemAnalyzerInfo{ "SNOWBALL(SPANISH)",    SystemAnalyzer::SNOWBALL_SPANISH,    true,  L"spanish" },
+        SystemAnalyzerInfo{ "SNOWBALL(SWEDISH)",    SystemAnalyzer::SNOWBALL_SWEDISH,    true,  L"swedish" },
+        SystemAnalyzerInfo{ "SNOWBALL(TURKISH)",    SystemAnalyzer::SNOWBALL_TURKISH,    true,  L"turkish" },
+        SystemAnalyzerInfo{ "STANDARD",             SystemAnalyzer::STANDARD,            true,  nullptr },
+        SystemAnalyzerInfo{ "STOP",                 SystemAnalyzer::STOP,                true,  nullptr },
+        SystemAnalyzerInfo{ "WHITESPACE",           SystemAnalyzer::WHITESPACE,          false, nullptr }
+    };
+
+    constexpr char asciiUpper(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    constexpr bool equalsNoCase(std::string_view s1, std::string_view s2)
+    {
+        if (s1.size() != s2.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < s1.size(); i++) {
+            if (asciiUpper(s1[i]) != asciiUpper(s2[i])) {
+                return false;
             }
         }
+        return true;
+    }
+
+    // case-independent FNV-1a hash
+    constexpr uint32_t hashNoCase(std::string_view s, uint32_t seed)
     {
+        uint32_t h = 2166136261u ^ seed;
+        for (const char c : s) {
+            h ^= static_cast<unsigned char>(asciiUpper(c));
+            h *= 16777619u;
+        }
+        return h;
+    }
 
+    constexpr size_t ANALYZER_HASH_TABLE_SIZE = 256;
+    constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+    static_assert(SYSTEM_ANALYZERS.size() < ANALYZER_HASH_TABLE_SIZE);
+
+    constexpr bool isPerfectSeed(uint32_t seed)
+    {
+        bool used[ANALYZER_HASH_TABLE_SIZE] = {};
+        for (const auto& info : SYSTEM_ANALYZERS) {
+            const auto slot = hashNoCase(info.name, seed) % ANALYZER_HASH_TABLE_SIZE;
+            if (used[slot]) {
+                return false;
+            }
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    constexpr uint32_t findPerfectSeed()
+    {
+        uint32_t seed = 0;
+        while (!isPerfectSeed(seed)) {
+            ++seed;
+        }
+        return seed;
     }
 
+    constexpr uint32_t ANALYZER_HASH_SEED = findPerfectSeed();
+
+    // Perfect hash table: slot -> index in SYSTEM_ANALYZERS, built at compile time.
+    constexpr auto ANALYZER_HASH_TABLE = []() {
+        std::array<uint8_t, ANALYZER_HASH_TABLE_SIZE> table{};
+        for (auto& slot : table) {
+            slot = EMPTY_SLOT;
+        }
+        for (size_t i = 0; i < SYSTEM_ANALYZERS.size(); i++) {
+            const auto slot = hashNoCase(SYSTEM_ANALYZERS[i].name, ANALYZER_HASH_SEED) % ANALYZER_HASH_TABLE_SIZE;
+            table[slot] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }();
+
+    constexpr const SystemAnalyzerInfo* findSystemAnalyzer(std::string_view analyzerName)
+    {
+        const auto index = ANALYZER_HASH_TABLE[hashNoCase(analyzerName, ANALYZER_HASH_SEED) % ANALYZER_HASH_TABLE_SIZE];
+        if (index == EMPTY_SLOT) {
+            return nullptr;
+        }
+        const auto& info = SYSTEM_ANALYZERS[index];
+        return equalsNoCase(info.name, analyzerName) ? &info : nullptr;
+    }
+
+    static_assert(findSystemAnalyzer("standard") == &SYSTEM_ANALYZERS[static_cast<size_t>(SystemAnalyzer::STANDARD)]);
+    static_assert(findSystemAnalyzer("Snowball(Russian)") == &SYSTEM_ANALYZERS[static_cast<size_t>(SystemAnalyzer::SNOWBALL_RUSSIAN)]);
+    static_assert(findSystemAnalyzer("UNKNOWN") == nullptr);
+    static_assert(findSystemAnalyzer("edge_ngram") == &SYSTEM_ANALYZERS[static_cast<size_t>(SystemAnalyzer::EDGE_NGRAM)]);
+
+    const SystemAnalyzerInfo& getSystemAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName)
+    {
+        const auto info = findSystemAnalyzer(analyzerName);
+        if (!info) {
+            std::string sAnalyzerName{ analyzerName };
+            LuceneUDR::throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
+        }
+        return *info;
+    }
+
+    HashSet<String> getDefaultStopWords(SystemAnalyzer kind)
+    {
+        switch (kind) {
+        case SystemAnalyzer::STANDARD:
+        case SystemAnalyzer::STOP:
+        case SystemAnalyzer::SNOWBALL_ENGLISH:
+        case SystemAnalyzer::SNOWBALL_PORTER:
+            return StopAnalyzer::ENGLISH_STOP_WORDS_SET();
+        case SystemAnalyzer::ARABIC:
+            return ArabicAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::BRAZILIAN:
+            return BrazilianAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::CJK:
+            return CJKAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::CZECH:
+            return CzechAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::DUTCH:
+        case SystemAnalyzer::SNOWBALL_DUTCH:
+            return DutchAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::ENGLISH:
+            return EnglishAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::FRENCH:
+        case SystemAnalyzer::SNOWBALL_FRENCH:
+            return FrenchAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::GERMAN:
+        case SystemAnalyzer::SNOWBALL_GERMAN:
+            return GermanAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::GREEK:
+            return GreekAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::PERSIAN:
+            return PersianAnalyzer::getDefaultStopSet();
+        case SystemAnalyzer::RUSSIAN:
+        case SystemAnalyzer::SNOWBALL_RUSSIAN:
+            return RussianAnalyzer::getDefaultStopSet();
+        default:
+            return HashSet<String>::newInstance();
+        }
+    }
+
+    // Analyzers whose terms are the lowercased words of the text. 
+    // The others stem, normalize or split words into n-grams.
+    bool isWordPreservingAnalyzer(SystemAnalyzer kind)
+    {
+        switch (kind) {
+        case SystemAnalyzer::KEYWORD:
+        case SystemAnalyzer::SIMPLE:
+        case SystemAnalyzer::STANDARD:
+        case SystemAnalyzer::STOP:
+        case SystemAnalyzer::WHITESPACE:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    AnalyzerPtr makeAnalyzer(const SystemAnalyzerInfo& info)
+    {
+        switch (info.kind) {
+        case SystemAnalyzer::STANDARD:
+            return newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::SIMPLE:
+            return newLucene<SimpleAnalyzer>();
+        case SystemAnalyzer::WHITESPACE:
+            return newLucene<WhitespaceAnalyzer>();
+        case SystemAnalyzer::KEYWORD:
+            return newLucene<KeywordAnalyzer>();
+        case SystemAnalyzer::STOP:
+            return newLucene<StopAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::ARABIC:
+            return newLucene<ArabicAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::BRAZILIAN:
+            return newLucene<BrazilianAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::CHINESE:
+            return newLucene<ChineseAnalyzer>();
+        case SystemAnalyzer::CJK:
+            return newLucene<CJKAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::CZECH:
+            return newLucene<CzechAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::DUTCH:
+            return newLucene<DutchAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::ENGLISH:
+            return newLucene<EnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::FRENCH:
+            return newLucene<FrenchAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::GERMAN:
+            return newLucene<GermanAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::GREEK:
+            return newLucene<GreekAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::PERSIAN:
+            return newLucene<PersianAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::RUSSIAN:
+            return newLucene<RussianAnalyzer>(LuceneVersion::LUCENE_CURRENT);
+        case SystemAnalyzer::NGRAM:
+            return newLucene<NGramAnalyzer>(LuceneVersion::LUCENE_CURRENT, 
+                NGramAnalyzer::DEFAULT_MIN_GRAM, NGramAnalyzer::DEFAULT_MAX_GRAM, false);
+        case SystemAnalyzer::EDGE_NGRAM:
+            return newLucene<NGramAnalyzer>(LuceneVersion::LUCENE_CURRENT, 
+                NGramAnalyzer::DEFAULT_EDGE_MIN_GRAM, NGramAnalyzer::DEFAULT_EDGE_MAX_GRAM, true);
+        default:
+        {
+            // snowball analyzers use the default stop words of the language, if any
+            const auto stopWords = getDefaultStopWords(info.kind);
+            if (stopWords.empty()) {
+                return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, info.snowballLanguage);
+            }
+            return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, info.snowballLanguage, stopWords);
+        }
+        }
+    }
+
+    AnalyzerPtr makeAnalyzer(const SystemAnalyzerInfo& info, const HashSet<String>& stopWords, const LuceneUDR::NGramSizes& gramSizes)
+    {
+        switch (info.kind) {
+        case SystemAnalyzer::NGRAM:
+            return newLucene<NGramAnalyzer>(LuceneVersion::LUCENE_CURRENT, 
+                gramSizes.minGram > 0 ? gramSizes.minGram : NGramAnalyzer::DEFAULT_MIN_GRAM,
+                gramSizes.maxGram > 0 ? gramSizes.maxGram : NGramAnalyzer::DEFAULT_MAX_GRAM,
+                false, stopWords);
+        case SystemAnalyzer::EDGE_NGRAM:
+            return newLucene<NGramAnalyzer>(LuceneVersion::LUCENE_CURRENT, 
+                gramSizes.minGram > 0 ? gramSizes.minGram : NGramAnalyzer::DEFAULT_EDGE_MIN_GRAM,
+                gramSizes.maxGram > 0 ? gramSizes.maxGram : NGramAnalyzer::DEFAULT_EDGE_MAX_GRAM,
+                true, stopWords);
+        case SystemAnalyzer::STANDARD:
+            return newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::STOP:
+            return newLucene<StopAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::ARABIC:
+            return newLucene<ArabicAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::BRAZILIAN:
+            return newLucene<BrazilianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::CJK:
+            return newLucene<CJKAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::CZECH:
+            return newLucene<CzechAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::DUTCH:
+            return newLucene<DutchAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::ENGLISH:
+            return newLucene<EnglishAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::FRENCH:
+            return newLucene<FrenchAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::GERMAN:
+            return newLucene<GermanAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::GREEK:
+            return newLucene<GreekAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::PERSIAN:
+            return newLucene<PersianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        case SystemAnalyzer::RUSSIAN:
+            return newLucene<RussianAnalyzer>(LuceneVersion::LUCENE_CURRENT, stopWords);
+        default:
+            if (info.snowballLanguage) {
+                return newLucene<SnowballAnalyzer>(LuceneVersion::LUCENE_CURRENT, info.snowballLanguage, stopWords);
+            }
+            // analyzer does not support stop words
+            return nullptr;
+        }
+    }
+
+    struct PooledAnalyzer
+    {
+        std::string definition;
+        AnalyzerPtr analyzer;
+    };
+
+    // Process-wide pool of ready analyzer instances. 
+    // Analyzers are safe to share between threads, 
+    // since Lucene keeps reusable token streams per thread.
+    std::mutex analyzerPoolMutex;
+    std::array<AnalyzerPtr, SYSTEM_ANALYZERS.size()> systemAnalyzerPool;
+    std::map<std::string, PooledAnalyzer> customAnalyzerPool;
+}
+
+namespace LuceneUDR 
+{
+
+    LuceneAnalyzerFactory::LuceneAnalyzerFactory() = default;
+
     LuceneAnalyzerFactory::~LuceneAnalyzerFactory() = default;
 
     bool LuceneAnalyzerFactory::hasAnalyzer(std::string_view analyzerName) const
     {
-        return (m_factories.find(analyzerName) != m_factories.end());
+        return findSystemAnalyzer(analyzerName) != nullptr;
     }
 
     bool LuceneAnalyzerFactory::isStopWordsSupported(std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
-            return false;
-        }
-        auto factory = pFactory->second;
-        return factory.stopWordsSupported;
+        const auto info = findSystemAnalyzer(analyzerName);
+        return info && info->stopWordsSupported;
+    }
+
+    bool LuceneAnalyzerFactory::isWordPreserving(std::string_view analyzerName) const
+    {
+        const auto info = findSystemAnalyzer(analyzerName);
+        return info && isWordPreservingAnalyzer(info->kind);
     }
 
     AnalyzerPtr LuceneAnalyzerFactory::createAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
-            std::string sAnalyzerName{ analyzerName };
-            throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
-        }
-        auto factory = pFactory->second;
-        return factory.simpleFactory();
+        const auto& info = getSystemAnalyzer(status, analyzerName);
+        return makeAnalyzer(info);
     }
 
     AnalyzerPtr LuceneAnalyzerFactory::createAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName, const HashSet<String> stopWords) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
-            std::string sAnalyzerName{ analyzerName };
-            throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
+        return createAnalyzer(status, analyzerName, stopWords, NGramSizes{});
+    }
+
+    AnalyzerPtr LuceneAnalyzerFactory::createAnalyzer(
+        ThrowStatusWrapper* status, 
+        std::string_view analyzerName, 
+        const HashSet<String> stopWords, 
+        const NGramSizes& gramSizes) const
+    {
+        const auto& info = getSystemAnalyzer(status, analyzerName);
+        try {
+            return makeAnalyzer(info, stopWords, gramSizes);
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+        return nullptr;
+    }
+
+    AnalyzerPtr LuceneAnalyzerFactory::getAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName) const
+    {
+        const auto& info = getSystemAnalyzer(status, analyzerName);
+        auto& pooled = systemAnalyzerPool[static_cast<size_t>(info.kind)];
+        {
+            std::lock_guard<std::mutex> lock(analyzerPoolMutex);
+            if (pooled) {
+                return pooled;
+            }
+        }
+        // the analyzer is built outside the lock, if two threads race the first one wins
+        auto analyzer = makeAnalyzer(info);
+
+        std::lock_guard<std::mutex> lock(analyzerPoolMutex);
+        if (!pooled) {
+            pooled = analyzer;
+        }
+        return pooled;
+    }
+
+    AnalyzerPtr LuceneAnalyzerFactory::getAnalyzer(
+        ThrowStatusWrapper* status,
+        std::string_view analyzerName,
+        std::string_view baseAnalyzer,
+        const std::vector<std::string>& stopWords,
+        const NGramSizes& gramSizes) const
+    {
+        std::string definition(baseAnalyzer);
+        definition += '\n';
+        definition += std::to_string(gramSizes.minGram);
+        definition += '\n';
+        definition += std::to_string(gramSizes.maxGram);
+        for (const auto& stopWord : stopWords) {
+            definition += '\n';
+            definition += stopWord;
         }
-        auto factory = pFactory->second;
-        return factory.extFactory(stopWords);
+
+        std::string sAnalyzerName(analyzerName);
+        {
+            std::lock_guard<std::mutex> lock(analyzerPoolMutex);
+            if (const auto it = customAnalyzerPool.find(sAnalyzerName); it != customAnalyzerPool.end() && it->second.definition == definition) {
+                return it->second.analyzer;
+            }
+        }
+
+        auto uStopWords = HashSet<String>::newInstance();
+        for (const auto& stopWord : stopWords) {
+            uStopWords.add(StringUtils::toUnicode(stopWord));
+        }
+        auto analyzer = createAnalyzer(status, baseAnalyzer, uStopWords, gramSizes);
+
+        std::lock_guard<std::mutex> lock(analyzerPoolMutex);
+        customAnalyzerPool.insert_or_assign(std::move(sAnalyzerName), PooledAnalyzer{ std::move(definition), analyzer });
+        return analyzer;
     }
 
     std::unordered_set<std::string> LuceneAnalyzerFactory::getAnalyzerNames() const
     {
         std::unordered_set<std::string> names;
-        for (auto&& pFactory : m_factories) {
-            names.insert(pFactory.first);
+        for (const auto& info : SYSTEM_ANALYZERS) {
+            names.emplace(info.name);
         }
         return names;
     }
 
     AnalyzerInfo LuceneAnalyzerFactory::getAnalyzerInfo(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
-            std::string sAnalyzerName{ analyzerName };
-            throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
-        }
-        auto factory = pFactory->second;
-        return { analyzerName, "", factory.stopWordsSupported, true };
+        const auto& info = getSystemAnalyzer(status, analyzerName);
+        return { analyzerName, "", info.stopWordsSupported, true };
     }
 
     std::list<AnalyzerInfo> LuceneAnalyzerFactory::getAnalyzerInfos() const
     {
         std::list<AnalyzerInfo> infos;
-        for (const auto& pFactory : m_factories) {
-            infos.emplace_back(pFactory.first, "", pFactory.second.stopWordsSupported, true);
+        for (const auto& info : SYSTEM_ANALYZERS) {
+            infos.emplace_back(info.name, "", info.stopWordsSupported, true);
         }
         return infos;
     }
 
     HashSet<String> LuceneAnalyzerFactory::getAnalyzerStopWords(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
-            std::string sAnalyzerName{ analyzerName };
-            throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
-        }
-        auto factory = pFactory->second;
-        return factory.getStopWords();
+        const auto& info = getSystemAnalyzer(status, analyzerName);
+        return getDefaultStopWords(info.kind);
     }
 }
@@ -14,11 +14,13 @@
  *  Contributor(s): ______________________________________.
 **/
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
 #include <string_view>
 #include <unordered_set>
+#include <vector>
 
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
@@ -49,6 +51,16 @@ namespace LuceneUDR
 
     constexpr const char* DEFAULT_ANALYZER_NAME = "STANDARD";
 
+    /// <summary>
+    /// Gram sizes of the analyzers based on NGRAM and EDGE_NGRAM. 
+    /// Zero means the default size of the base analyzer.
+    /// </summary>
+    struct NGramSizes
+    {
+        int32_t minGram = 0;
+        int32_t maxGram = 0;
+    };
+
     struct AnalyzerInfo
     {
         AnalyzerInfo() = default;
@@ -63,20 +75,10 @@ namespace LuceneUDR
         std::string baseAnalyzer;
         bool stopWordsSupported;
         bool systemFlag;
+        NGramSizes gramSizes;
     };
 
     class LuceneAnalyzerFactory final {
-    private:
-        struct AnalyzerFactory
-        {
-            std::function<Lucene::AnalyzerPtr()> simpleFactory;
-            std::function<Lucene::AnalyzerPtr(const Lucene::HashSet<Lucene::String>)> extFactory;
-            std::function<Lucene::HashSet<Lucene::String>()> getStopWords;
-            bool stopWordsSupported;
-        };
-
-        std::map<std::string, AnalyzerFactory, ci_less> m_factories;
-
     public:
 
         LuceneAnalyzerFactory();
@@ -87,10 +89,55 @@ namespace LuceneUDR
 
         bool isStopWordsSupported(std::string_view analyzerName) const;
 
+        /// <summary>
+        /// Returns whether the terms of the system analyzer are the words of the text, 
+        /// not stems or n-grams. Words may only be lowercased.
+        /// </summary>
+        bool isWordPreserving(std::string_view analyzerName) const;
+
         Lucene::AnalyzerPtr createAnalyzer(Firebird::ThrowStatusWrapper* status, std::string_view analyzerName) const;
 
         Lucene::AnalyzerPtr createAnalyzer(Firebird::ThrowStatusWrapper* status, std::string_view analyzerName, const Lucene::HashSet<Lucene::String> stopWords) const;
 
+        Lucene::AnalyzerPtr createAnalyzer(
+            Firebird::ThrowStatusWrapper* status, 
+            std::string_view analyzerName, 
+            const Lucene::HashSet<Lucene::String> stopWords, 
+            const NGramSizes& gramSizes
+        ) const;
+
+        /// <summary>
+        /// Returns the system analyzer instance from the process-wide pool. 
+        /// The analyzer is created on first request and then shared by all callers.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="analyzerName">System analyzer name</param>
+        /// 
+        /// <returns>Shared analyzer instance</returns>
+        Lucene::AnalyzerPtr getAnalyzer(Firebird::ThrowStatusWrapper* status, std::string_view analyzerName) const;
+
+        /// <summary>
+        /// Returns the custom analyzer instance from the process-wide pool. 
+        /// The pooled instance is rebuilt if the effective definition of the analyzer 
+        /// (base analyzer, gram sizes and stop words) differs from the pooled one.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="analyzerName">Custom analyzer name</param>
+        /// <param name="baseAnalyzer">Base analyzer name</param>
+        /// <param name="stopWords">Sorted list of stop words</param>
+        /// <param name="gramSizes">Gram sizes for analyzers based on NGRAM and EDGE_NGRAM</param>
+        /// 
+        /// <returns>Shared analyzer instance</returns>
+        Lucene::AnalyzerPtr getAnalyzer(
+            Firebird::ThrowStatusWrapper* status,
+            std::string_view analyzerName,
+            std::string_view baseAnalyzer,
+            const std::vector<std::string>& stopWords,
+            const NGramSizes& gramSizes = {}
+        ) const;
+
         std::unordered_set<std::string> getAnalyzerNames() const;
 
         AnalyzerInfo getAnalyzerInfo(Firebird::ThrowStatusWrapper* status, std::string_view analyzerName) const;
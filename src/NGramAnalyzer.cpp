@@ -0,0 +1,181 @@
+/**
+ *  Analyzers that split words into n-grams for substring and prefix search.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "NGramAnalyzer.h"
+
+#include <algorithm>
+
+#include "StandardAnalyzer.h"
+
+namespace Lucene 
+{
+
+    NGramFilter::NGramFilter(const TokenStreamPtr& input, int32_t minGram, int32_t maxGram, bool edgesOnly, bool queryMode)
+        : TokenFilter(input)
+        , minGram(minGram)
+        , maxGram(maxGram)
+        , edgesOnly(edgesOnly)
+        , queryMode(queryMode)
+        , hasCurrent(false)
+        , curStartOffset(0)
+        , gramStart(0)
+        , gramSize(0)
+        , minSize(0)
+        , lastStart(0)
+        , pendingPosIncr(0)
+    {
+        termAtt = addAttribute<TermAttribute>();
+        offsetAtt = addAttribute<OffsetAttribute>();
+        posIncrAtt = addAttribute<PositionIncrementAttribute>();
+    }
+
+    NGramFilter::~NGramFilter() {
+    }
+
+    bool NGramFilter::incrementToken()
+    {
+        while (true) {
+            if (!hasCurrent) {
+                if (!input->incrementToken()) {
+                    return false;
+                }
+                const int32_t length = termAtt->termLength();
+                if (length < minGram || (queryMode && length <= maxGram)) {
+                    // the whole token is a term of the index
+                    return true;
+                }
+                curTerm.assign(termAtt->termBufferArray(), length);
+                curStartOffset = offsetAtt->startOffset();
+                pendingPosIncr = posIncrAtt->getPositionIncrement();
+                minSize = queryMode ? maxGram : minGram;
+                lastStart = edgesOnly ? 0 : length - minSize;
+                gramStart = 0;
+                gramSize = minSize;
+                hasCurrent = true;
+            }
+
+            if (gramStart > lastStart) {
+                hasCurrent = false;
+                continue;
+            }
+            if (gramSize > std::min(maxGram, static_cast<int32_t>(curTerm.length()) - gramStart)) {
+                // all grams of this start are done, the next start takes the next position
+                ++gramStart;
+                gramSize = minSize;
+                pendingPosIncr = 1;
+                continue;
+            }
+
+            clearAttributes();
+            termAtt->setTermBuffer(curTerm.c_str(), gramStart, gramSize);
+            offsetAtt->setOffset(curStartOffset + gramStart, curStartOffset + gramStart + gramSize);
+            posIncrAtt->setPositionIncrement(pendingPosIncr);
+            pendingPosIncr = 0;
+            ++gramSize;
+            return true;
+        }
+    }
+
+    void NGramFilter::reset()
+    {
+        TokenFilter::reset();
+        hasCurrent = false;
+    }
+
+    const int32_t NGramAnalyzer::DEFAULT_MIN_GRAM = 3;
+    const int32_t NGramAnalyzer::DEFAULT_MAX_GRAM = 3;
+    const int32_t NGramAnalyzer::DEFAULT_EDGE_MIN_GRAM = 2;
+    const int32_t NGramAnalyzer::DEFAULT_EDGE_MAX_GRAM = 20;
+    const int32_t NGramAnalyzer::MAX_GRAM_LIMIT = 255;
+
+    NGramAnalyzer::NGramAnalyzer(LuceneVersion::Version matchVersion, int32_t minGram, int32_t maxGram, bool edgesOnly, HashSet<String> stopWords)
+        : NGramAnalyzer(matchVersion, minGram, maxGram, edgesOnly, stopWords, false)
+    {
+        queryAnalyzer = newLucene<NGramAnalyzer>(matchVersion, minGram, maxGram, edgesOnly, stopWords, true);
+    }
+
+    NGramAnalyzer::NGramAnalyzer(LuceneVersion::Version matchVersion, int32_t minGram, int32_t maxGram, bool edgesOnly, HashSet<String> stopWords, bool queryMode)
+        : matchVersion(matchVersion)
+        , stopSet(stopWords)
+        , enableStopPositionIncrements(StopFilter::getEnablePositionIncrementsVersionDefault(matchVersion))
+        , minGram(minGram)
+        , maxGram(maxGram)
+        , edgesOnly(edgesOnly)
+        , queryMode(queryMode)
+    {
+        if (minGram < 1 || maxGram < minGram || maxGram > MAX_GRAM_LIMIT) {
+            boost::throw_exception(IllegalArgumentException(
+                L"Invalid n-gram sizes " + StringUtils::toString(minGram) + L".." + StringUtils::toString(maxGram)));
+        }
+    }
+
+    NGramAnalyzer::~NGramAnalyzer() {
+    }
+
+    AnalyzerPtr NGramAnalyzer::getQueryAnalyzer()
+    {
+        return queryMode ? boost::static_pointer_cast<Analyzer>(shared_from_this()) : queryAnalyzer;
+    }
+
+    AnalyzerPtr NGramAnalyzer::getQueryAnalyzer(const AnalyzerPtr& indexAnalyzer)
+    {
+        if (auto ngramAnalyzer = boost::dynamic_pointer_cast<NGramAnalyzer>(indexAnalyzer)) {
+            return ngramAnalyzer->getQueryAnalyzer();
+        }
+        return indexAnalyzer;
+    }
+
+    int32_t NGramAnalyzer::getMinGram() const
+    {
+        return minGram;
+    }
+
+    int32_t NGramAnalyzer::getMaxGram() const
+    {
+        return maxGram;
+    }
+
+    TokenStreamPtr NGramAnalyzer::makeFilters(const TokenStreamPtr& source)
+    {
+        TokenStreamPtr result = newLucene<StandardFilter>(source);
+        result = newLucene<LowerCaseFilter>(result);
+        if (!stopSet.empty()) {
+            result = newLucene<StopFilter>(enableStopPositionIncrements, result, stopSet);
+        }
+        return newLucene<NGramFilter>(result, minGram, maxGram, edgesOnly, queryMode);
+    }
+
+    TokenStreamPtr NGramAnalyzer::tokenStream([[maybe_unused]] const String& fieldName, const ReaderPtr& reader)
+    {
+        return makeFilters(newLucene<StandardTokenizer>(matchVersion, reader));
+    }
+
+    TokenStreamPtr NGramAnalyzer::reusableTokenStream([[maybe_unused]] const String& fieldName, const ReaderPtr& reader)
+    {
+        auto streams = boost::dynamic_pointer_cast<NGramAnalyzerSavedStreams>(getPreviousTokenStream());
+        if (!streams) {
+            streams = newLucene<NGramAnalyzerSavedStreams>();
+            setPreviousTokenStream(streams);
+            streams->tokenStream = newLucene<StandardTokenizer>(matchVersion, reader);
+            streams->filteredTokenStream = makeFilters(streams->tokenStream);
+        }
+        else {
+            streams->tokenStream->reset(reader);
+        }
+        return streams->filteredTokenStream;
+    }
+
+    NGramAnalyzerSavedStreams::~NGramAnalyzerSavedStreams() {
+    }
+
+}
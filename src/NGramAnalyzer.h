@@ -0,0 +1,136 @@
+#ifndef LUCENE_NGRAM_ANALYZER_H
+#define LUCENE_NGRAM_ANALYZER_H
+
+/**
+ *  Analyzers that split words into n-grams for substring and prefix search.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+#include "LuceneHeaders.h"
+#include "Analyzer.h"
+#include "TokenFilter.h"
+
+namespace Lucene 
+{
+    /// Splits each token into grams of minGram..maxGram characters. 
+    /// The grams starting at the same character share a position and consecutive start characters 
+    /// take consecutive positions, so a phrase of grams matches a substring of the word. 
+    /// Tokens shorter than minGram are passed unchanged.
+    ///
+    /// In query mode a token is not split unless it is longer than maxGram. A longer token becomes 
+    /// the phrase of its maxGram-long grams (or its maxGram-long prefix for edge n-grams), 
+    /// which is looked up with exact terms instead of a wildcard scan of the term dictionary.
+    class NGramFilter : public TokenFilter {
+    public:
+        /// @param input source token stream
+        /// @param minGram the smallest n-gram to generate
+        /// @param maxGram the largest n-gram to generate
+        /// @param edgesOnly generate only the grams that start at the beginning of the token
+        /// @param queryMode produce tokens for searching instead of indexing
+        NGramFilter(const TokenStreamPtr& input, int32_t minGram, int32_t maxGram, bool edgesOnly, bool queryMode);
+
+        virtual ~NGramFilter();
+
+        LUCENE_CLASS(NGramFilter);
+
+    protected:
+        int32_t minGram;
+        int32_t maxGram;
+        bool edgesOnly;
+        bool queryMode;
+
+        TermAttributePtr termAtt;
+        OffsetAttributePtr offsetAtt;
+        PositionIncrementAttributePtr posIncrAtt;
+
+        // token being split
+        bool hasCurrent;
+        String curTerm;
+        int32_t curStartOffset;
+        int32_t gramStart;
+        int32_t gramSize;
+        int32_t minSize;
+        int32_t lastStart;
+        int32_t pendingPosIncr;
+
+    public:
+        virtual bool incrementToken();
+        virtual void reset();
+    };
+
+    /// Analyzer for substring (NGRAM) and prefix (EDGE_NGRAM) search. 
+    /// Text is split by {@link StandardTokenizer}, lowercased, stop words are removed 
+    /// and the remaining words are split into n-grams by {@link NGramFilter}.
+    class NGramAnalyzer : public Analyzer {
+    public:
+        /// @param matchVersion Lucene version to match.
+        /// @param minGram the smallest n-gram to generate
+        /// @param maxGram the largest n-gram to generate
+        /// @param edgesOnly generate only the grams that start at the beginning of a word
+        /// @param stopWords stop words
+        NGramAnalyzer(LuceneVersion::Version matchVersion, int32_t minGram, int32_t maxGram, bool edgesOnly, 
+            HashSet<String> stopWords = HashSet<String>::newInstance());
+
+        virtual ~NGramAnalyzer();
+
+        LUCENE_CLASS(NGramAnalyzer);
+
+    public:
+        static const int32_t DEFAULT_MIN_GRAM;
+        static const int32_t DEFAULT_MAX_GRAM;
+        static const int32_t DEFAULT_EDGE_MIN_GRAM;
+        static const int32_t DEFAULT_EDGE_MAX_GRAM;
+        /// Largest gram size accepted by the analyzer.
+        static const int32_t MAX_GRAM_LIMIT;
+
+    protected:
+        LuceneVersion::Version matchVersion;
+        HashSet<String> stopSet;
+        bool enableStopPositionIncrements;
+        int32_t minGram;
+        int32_t maxGram;
+        bool edgesOnly;
+        bool queryMode;
+        AnalyzerPtr queryAnalyzer;
+
+        TokenStreamPtr makeFilters(const TokenStreamPtr& source);
+
+    public:
+        /// Builds the analyzer for indexing (queryMode = false) or for parsing search queries.
+        NGramAnalyzer(LuceneVersion::Version matchVersion, int32_t minGram, int32_t maxGram, bool edgesOnly, 
+            HashSet<String> stopWords, bool queryMode);
+
+        /// Returns the analyzer to be used for parsing search queries over fields indexed by this analyzer.
+        AnalyzerPtr getQueryAnalyzer();
+
+        /// Returns the analyzer to be used for parsing search queries over fields indexed by the given analyzer. 
+        /// For analyzers other than NGramAnalyzer this is the analyzer itself.
+        static AnalyzerPtr getQueryAnalyzer(const AnalyzerPtr& indexAnalyzer);
+
+        int32_t getMinGram() const;
+        int32_t getMaxGram() const;
+
+        virtual TokenStreamPtr tokenStream(const String& fieldName, const ReaderPtr& reader);
+        virtual TokenStreamPtr reusableTokenStream(const String& fieldName, const ReaderPtr& reader);
+    };
+
+    class NGramAnalyzerSavedStreams : public LuceneObject {
+    public:
+        virtual ~NGramAnalyzerSavedStreams();
+
+    public:
+        StandardTokenizerPtr tokenStream;
+        TokenStreamPtr filteredTokenStream;
+    };
+
+    typedef boost::shared_ptr<NGramAnalyzer> NGramAnalyzerPtr;
+}
+
+#endif
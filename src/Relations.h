@@ -98,6 +98,11 @@ namespace FTSMetadata
             return (fieldType == 261);
         }
 
+        bool isDateOrTimestamp() const {
+            // DATE, TIMESTAMP, TIMESTAMP WITH TIME ZONE
+            return (fieldType == 12 || fieldType == 35 || fieldType == 29);
+        }
+
         bool isBinary() const {
             return (isBlob() && fieldSubType == 0) || ((isFixedChar() || isVarChar()) && charsetId == 1);
         }
@@ -0,0 +1,91 @@
+/**
+ *  Analyzer wrapper that indexes companion fields with reversed terms.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "ReverseFieldAnalyzer.h"
+
+#include <algorithm>
+
+#include "TermAttribute.h"
+
+namespace Lucene 
+{
+
+    ReverseTermFilter::ReverseTermFilter(const TokenStreamPtr& input)
+        : TokenFilter(input)
+    {
+        termAtt = addAttribute<TermAttribute>();
+    }
+
+    ReverseTermFilter::~ReverseTermFilter() {
+    }
+
+    bool ReverseTermFilter::incrementToken()
+    {
+        if (!input->incrementToken()) {
+            return false;
+        }
+        wchar_t* buffer = termAtt->termBufferArray();
+        std::reverse(buffer, buffer + termAtt->termLength());
+        return true;
+    }
+
+    String ReverseTermFilter::reverse(const String& term)
+    {
+        return String(term.rbegin(), term.rend());
+    }
+
+    ReverseFieldAnalyzer::ReverseFieldAnalyzer(const AnalyzerPtr& analyzer, const String& reverseSuffix)
+        : analyzer(analyzer)
+        , reverseSuffix(reverseSuffix)
+    {
+    }
+
+    ReverseFieldAnalyzer::~ReverseFieldAnalyzer() {
+    }
+
+    bool ReverseFieldAnalyzer::isReverseField(const String& fieldName) const
+    {
+        return fieldName.length() > reverseSuffix.length() &&
+            fieldName.compare(fieldName.length() - reverseSuffix.length(), reverseSuffix.length(), reverseSuffix) == 0;
+    }
+
+    TokenStreamPtr ReverseFieldAnalyzer::tokenStream(const String& fieldName, const ReaderPtr& reader)
+    {
+        if (isReverseField(fieldName)) {
+            const String baseFieldName = fieldName.substr(0, fieldName.length() - reverseSuffix.length());
+            return newLucene<ReverseTermFilter>(analyzer->tokenStream(baseFieldName, reader));
+        }
+        return analyzer->tokenStream(fieldName, reader);
+    }
+
+    TokenStreamPtr ReverseFieldAnalyzer::reusableTokenStream(const String& fieldName, const ReaderPtr& reader)
+    {
+        // the saved streams of the wrapped analyzer are shared by all fields, 
+        // so the reversed field gets a fresh chain instead of wrapping them
+        if (isReverseField(fieldName)) {
+            return tokenStream(fieldName, reader);
+        }
+        return analyzer->reusableTokenStream(fieldName, reader);
+    }
+
+    int32_t ReverseFieldAnalyzer::getPositionIncrementGap(const String& fieldName)
+    {
+        return analyzer->getPositionIncrementGap(fieldName);
+    }
+
+    int32_t ReverseFieldAnalyzer::getOffsetGap(const FieldablePtr& field)
+    {
+        return analyzer->getOffsetGap(field);
+    }
+
+}
@@ -0,0 +1,66 @@
+#ifndef LUCENE_REVERSE_FIELD_ANALYZER_H
+#define LUCENE_REVERSE_FIELD_ANALYZER_H
+
+/**
+ *  Analyzer wrapper that indexes companion fields with reversed terms.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Analyzer.h"
+#include "TokenFilter.h"
+
+namespace Lucene 
+{
+    /// Reverses the characters of each term, so that a suffix of a word becomes a prefix.
+    class ReverseTermFilter : public TokenFilter {
+    public:
+        ReverseTermFilter(const TokenStreamPtr& input);
+
+        virtual ~ReverseTermFilter();
+
+        LUCENE_CLASS(ReverseTermFilter);
+
+    protected:
+        TermAttributePtr termAtt;
+
+    public:
+        virtual bool incrementToken();
+
+        /// Reverses a term the same way as the filter does.
+        static String reverse(const String& term);
+    };
+
+    /// Delegates to the analyzer of the index. Fields whose names end with the given suffix 
+    /// are analyzed as the field without the suffix and then their terms are reversed.
+    class ReverseFieldAnalyzer : public Analyzer {
+    public:
+        ReverseFieldAnalyzer(const AnalyzerPtr& analyzer, const String& reverseSuffix);
+
+        virtual ~ReverseFieldAnalyzer();
+
+        LUCENE_CLASS(ReverseFieldAnalyzer);
+
+    protected:
+        AnalyzerPtr analyzer;
+        String reverseSuffix;
+
+        bool isReverseField(const String& fieldName) const;
+
+    public:
+        virtual TokenStreamPtr tokenStream(const String& fieldName, const ReaderPtr& reader);
+        virtual TokenStreamPtr reusableTokenStream(const String& fieldName, const ReaderPtr& reader);
+        virtual int32_t getPositionIncrementGap(const String& fieldName);
+        virtual int32_t getOffsetGap(const FieldablePtr& field);
+    };
+}
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ *  Limits on the resources consumed by a full-text search.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "SearchLimits.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "FBUtils.h"
+#include "FuzzyTermEnum.h"
+#include "PrefixTermEnum.h"
+#include "WildcardTermEnum.h"
+
+using namespace Firebird;
+using namespace Lucene;
+
+namespace
+{
+    int64_t getLimitOption(ThrowStatusWrapper* status, const LuceneUDR::FtsConfig& config, std::string_view indexName, std::string_view key)
+    {
+        const auto value = config.getOption(indexName, key);
+        if (value.empty()) {
+            return 0;
+        }
+        try {
+            const auto limit = std::stoll(value);
+            if (limit >= 0) {
+                return limit;
+            }
+        }
+        catch (const std::logic_error&) {
+        }
+        const std::string keyStr(key);
+        LuceneUDR::throwException(status, R"(Invalid value "%s" of option %s. Expected a non-negative integer.)", value.c_str(), keyStr.c_str());
+        return 0;
+    }
+
+    /// <summary>
+    /// Counts the terms of the enumeration, stopping as soon as the limit is exceeded.
+    /// </summary>
+    int64_t countTerms(const FilteredTermEnumPtr& termEnum, int64_t limit)
+    {
+        int64_t count = 0;
+        // a filtered enumeration is already positioned on the first matching term
+        while (termEnum->term() && count <= limit) {
+            ++count;
+            if (!termEnum->next()) {
+                break;
+            }
+        }
+        termEnum->close();
+        return count;
+    }
+
+    /// <summary>
+    /// Returns the number of terms the query expands to, counting no further than the limit.
+    /// </summary>
+    int64_t countExpansions(const IndexReaderPtr& reader, const QueryPtr& query, int64_t limit)
+    {
+        if (auto booleanQuery = boost::dynamic_pointer_cast<BooleanQuery>(query)) {
+            int64_t count = 0;
+            for (const auto& clause : booleanQuery->getClauses()) {
+                count += countExpansions(reader, clause->getQuery(), limit - count);
+                if (count > limit) {
+                    break;
+                }
+            }
+            return count;
+        }
+        if (auto wildcardQuery = boost::dynamic_pointer_cast<WildcardQuery>(query)) {
+            return countTerms(newLucene<WildcardTermEnum>(reader, wildcardQuery->getTerm()), limit);
+        }
+        if (auto prefixQuery = boost::dynamic_pointer_cast<PrefixQuery>(query)) {
+            return countTerms(newLucene<PrefixTermEnum>(reader, prefixQuery->getPrefix()), limit);
+        }
+        if (auto fuzzyQuery = boost::dynamic_pointer_cast<FuzzyQuery>(query)) {
+            return countTerms(
+                newLucene<FuzzyTermEnum>(reader, fuzzyQuery->getTerm(), fuzzyQuery->getMinSimilarity(), fuzzyQuery->getPrefixLength()), 
+                limit
+            );
+        }
+        return 0;
+    }
+}
+
+namespace LuceneUDR
+{
+
+    SearchLimits getSearchLimits(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName)
+    {
+        SearchLimits limits;
+        limits.timeout = getLimitOption(status, config, indexName, "searchTimeout");
+        limits.maxExpansions = getLimitOption(status, config, indexName, "maxExpansions");
+        return limits;
+    }
+
+    void checkQueryExpansions(ThrowStatusWrapper* status, const IndexReaderPtr& reader, const QueryPtr& query, int64_t maxExpansions)
+    {
+        if (maxExpansions <= 0) {
+            return;
+        }
+        if (countExpansions(reader, query, maxExpansions) > maxExpansions) {
+            throwException(status, "The query expands to more than %lld terms. Make wildcard, prefix or fuzzy terms more specific.", 
+                static_cast<long long>(maxExpansions));
+        }
+    }
+
+}
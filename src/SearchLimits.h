@@ -0,0 +1,65 @@
+#ifndef SEARCH_LIMITS_H
+#define SEARCH_LIMITS_H
+
+/**
+ *  Limits on the resources consumed by a full-text search.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <string_view>
+
+#include "LuceneUdr.h"
+#include "LuceneHeaders.h"
+#include "FTSUtils.h"
+
+namespace LuceneUDR
+{
+    /// <summary>
+    /// Limits of a single search. Zero means no limit.
+    /// </summary>
+    struct SearchLimits
+    {
+        // time allowed for collecting hits, in milliseconds
+        int64_t timeout = 0;
+        // maximum number of terms that wildcard, prefix and fuzzy queries can expand to
+        int64_t maxExpansions = 0;
+    };
+
+    /// <summary>
+    /// Returns the search limits of the index from the options searchTimeout and maxExpansions.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="config">Lucene UDR settings of the database</param>
+    /// <param name="indexName">Index name</param>
+    /// 
+    /// <returns>Search limits</returns>
+    SearchLimits getSearchLimits(Firebird::ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName);
+
+    /// <summary>
+    /// Checks that the wildcard, prefix and fuzzy queries contained in the query 
+    /// expand to no more than maxExpansions terms in total. 
+    /// Terms are enumerated only up to the limit, the query is not rewritten.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="reader">Index reader</param>
+    /// <param name="query">Parsed query</param>
+    /// <param name="maxExpansions">Maximum number of terms, 0 - no limit</param>
+    void checkQueryExpansions(
+        Firebird::ThrowStatusWrapper* status, 
+        const Lucene::IndexReaderPtr& reader, 
+        const Lucene::QueryPtr& query, 
+        int64_t maxExpansions);
+}
+
+#endif // SEARCH_LIMITS_H
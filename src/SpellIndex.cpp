@@ -0,0 +1,327 @@
+/**
+ *  Side index of the words of a full-text index for spelling correction.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "SpellIndex.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+#include "FBUtils.h"
+#include "IndexDirectory.h"
+
+using namespace Firebird;
+using namespace Lucene;
+using namespace FTSMetadata;
+
+namespace
+{
+    const String F_WORD = L"word";
+    // commit data of the spellchecker index: version of the full-text index it was taken from
+    const String SOURCE_VERSION = L"sourceVersion";
+
+    // words shorter than this are neither indexed nor corrected
+    constexpr size_t MIN_WORD_LENGTH = 3;
+    // minimum similarity of a suggested word
+    constexpr double MIN_SIMILARITY = 0.5;
+
+    std::mutex spellBuildMutex;
+
+    // gram sizes depend on the word length, as in the Lucene SpellChecker
+    int32_t getMinGram(size_t length)
+    {
+        return length > 5 ? 3 : (length == 5 ? 2 : 1);
+    }
+
+    int32_t getMaxGram(size_t length)
+    {
+        return length > 5 ? 4 : (length == 5 ? 3 : 2);
+    }
+
+    String gramField(const wchar_t* prefix, int32_t ng)
+    {
+        return prefix + StringUtils::toString(ng);
+    }
+
+    size_t levenshteinDistance(const String& a, const String& b)
+    {
+        std::vector<size_t> row(b.length() + 1);
+        for (size_t j = 0; j <= b.length(); ++j) {
+            row[j] = j;
+        }
+        for (size_t i = 1; i <= a.length(); ++i) {
+            size_t diagonal = row[0];
+            row[0] = i;
+            for (size_t j = 1; j <= b.length(); ++j) {
+                const size_t above = row[j];
+                row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1) });
+                diagonal = above;
+            }
+        }
+        return row[b.length()];
+    }
+
+    DocumentPtr makeWordDocument(const String& word)
+    {
+        auto doc = newLucene<Document>();
+        doc->add(newLucene<Field>(F_WORD, word, Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        const auto length = word.length();
+        for (int32_t ng = getMinGram(length); ng <= getMaxGram(length); ++ng) {
+            if (length < static_cast<size_t>(ng)) {
+                break;
+            }
+            const auto gramName = gramField(L"gram", ng);
+            for (size_t i = 0; i + ng <= length; ++i) {
+                const auto gram = word.substr(i, ng);
+                if (i == 0) {
+                    doc->add(newLucene<Field>(gramField(L"start", ng), gram, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+                }
+                if (i + ng == length) {
+                    doc->add(newLucene<Field>(gramField(L"end", ng), gram, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+                }
+                doc->add(newLucene<Field>(gramName, gram, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+            }
+        }
+        return doc;
+    }
+
+    // Versions only grow, so their sum changes whenever any shard changes.
+    String getSourceVersion(const Collection<DirectoryPtr>& sourceDirs)
+    {
+        int64_t version = 0;
+        for (const auto& sourceDir : sourceDirs) {
+            version += IndexReader::getCurrentVersion(sourceDir);
+        }
+        return StringUtils::toString(version);
+    }
+
+    Collection<DirectoryPtr> openSourceDirectories(const std::vector<fs::path>& shardPaths)
+    {
+        auto sourceDirs = Collection<DirectoryPtr>::newInstance();
+        for (const auto& shardPath : shardPaths) {
+            sourceDirs.add(FSDirectory::open(shardPath.wstring()));
+        }
+        return sourceDirs;
+    }
+
+    void closeSourceDirectories(const Collection<DirectoryPtr>& sourceDirs)
+    {
+        for (const auto& sourceDir : sourceDirs) {
+            sourceDir->close();
+        }
+    }
+
+    // Words of the given fields of the index. If the spellchecker index is given, only the words missing from it.
+    std::set<String> readIndexWords(const Collection<DirectoryPtr>& sourceDirs, const Collection<String>& fields, const IndexReaderPtr& spellReader)
+    {
+        std::set<String> words;
+        auto reader = LuceneUDR::openIndexReader(sourceDirs);
+        for (const auto& fieldName : fields) {
+            auto termEnum = reader->terms(newLucene<Term>(fieldName));
+            do {
+                auto term = termEnum->term();
+                if (!term || term->field() != fieldName) {
+                    break;
+                }
+                if (term->text().length() >= MIN_WORD_LENGTH && 
+                    (!spellReader || spellReader->docFreq(newLucene<Term>(F_WORD, term->text())) == 0)) 
+                {
+                    words.insert(term->text());
+                }
+            } while (termEnum->next());
+            termEnum->close();
+        }
+        reader->close();
+        return words;
+    }
+
+    // The version of the full-text index is saved with the words taken from it.
+    void commitSpellIndex(const IndexWriterPtr& writer, const String& sourceVersion)
+    {
+        auto commitUserData = MapStringString::newInstance();
+        commitUserData.put(SOURCE_VERSION, sourceVersion);
+        writer->commit(commitUserData);
+        writer->close();
+    }
+}
+
+namespace LuceneUDR
+{
+
+    Collection<String> getSpellFields(const FTSIndex& ftsIndex)
+    {
+        auto fields = Collection<String>::newInstance();
+        for (const auto& segment : ftsIndex.segments) {
+            if (!segment.isKey()) {
+                fields.add(StringUtils::toUnicode(segment.fieldName()));
+            }
+        }
+        return fields;
+    }
+
+    bool isSpellIndexEnabled(ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName)
+    {
+        const auto value = config.getOption(indexName, "spellIndex", "false");
+        if (value == "true") {
+            return true;
+        }
+        if (value != "false") {
+            throwException(status, R"(Invalid value "%s" of option spellIndex. Expected true or false.)", value.c_str());
+        }
+        return false;
+    }
+
+    void buildSpellIndex(const fs::path& indexDirectoryPath, const std::vector<fs::path>& shardPaths, const Collection<String>& fields)
+    {
+        // one build at a time, a second writer would fail on the directory lock
+        std::lock_guard<std::mutex> lock(spellBuildMutex);
+
+        auto sourceDirs = openSourceDirectories(shardPaths);
+        const auto sourceVersion = getSourceVersion(sourceDirs);
+        const auto words = readIndexWords(sourceDirs, fields, IndexReaderPtr());
+        closeSourceDirectories(sourceDirs);
+
+        const auto spellDirectoryPath = getSpellDirectoryPath(indexDirectoryPath);
+        createIndexDirectory(spellDirectoryPath);
+        auto spellDir = FSDirectory::open(spellDirectoryPath.wstring());
+        auto writer = newLucene<IndexWriter>(spellDir, newLucene<KeywordAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+        // the words are short documents, large buffers only speed up the build
+        writer->setMergeFactor(300);
+        writer->setMaxBufferedDocs(150);
+        for (const auto& word : words) {
+            writer->addDocument(makeWordDocument(word));
+        }
+        writer->optimize();
+        commitSpellIndex(writer, sourceVersion);
+        spellDir->close();
+    }
+
+    void updateSpellIndex(const fs::path& indexDirectoryPath, const std::vector<fs::path>& shardPaths, const Collection<String>& fields)
+    {
+        std::lock_guard<std::mutex> lock(spellBuildMutex);
+
+        const auto spellDirectoryPath = getSpellDirectoryPath(indexDirectoryPath);
+        if (!fs::is_directory(spellDirectoryPath)) {
+            return;
+        }
+        auto spellDir = FSDirectory::open(spellDirectoryPath.wstring());
+        if (!IndexReader::indexExists(spellDir)) {
+            spellDir->close();
+            return;
+        }
+
+        // the terms are only read again if the index has changed since they were last taken
+        auto sourceDirs = openSourceDirectories(shardPaths);
+        const auto sourceVersion = getSourceVersion(sourceDirs);
+        const auto commitUserData = IndexReader::getCommitUserData(spellDir);
+        if (commitUserData.contains(SOURCE_VERSION) && commitUserData.get(SOURCE_VERSION) == sourceVersion) {
+            closeSourceDirectories(sourceDirs);
+            spellDir->close();
+            return;
+        }
+
+        auto spellReader = IndexReader::open(spellDir, true);
+        const auto words = readIndexWords(sourceDirs, fields, spellReader);
+        spellReader->close();
+        closeSourceDirectories(sourceDirs);
+
+        auto writer = newLucene<IndexWriter>(spellDir, newLucene<KeywordAnalyzer>(), false, IndexWriter::MaxFieldLengthUNLIMITED);
+        for (const auto& word : words) {
+            writer->addDocument(makeWordDocument(word));
+        }
+        commitSpellIndex(writer, sourceVersion);
+        spellDir->close();
+    }
+
+    SpellChecker::SpellChecker(const fs::path& spellDirectoryPath, const IndexReaderPtr& indexReader, const Collection<String>& fields)
+        : m_indexReader(indexReader)
+        , m_fields(fields)
+    {
+        auto spellDir = FSDirectory::open(spellDirectoryPath.wstring());
+        m_reader = IndexReader::open(spellDir, true);
+        m_searcher = newLucene<IndexSearcher>(m_reader);
+    }
+
+    SpellChecker::~SpellChecker()
+    {
+        try {
+            m_searcher->close();
+            m_reader->close();
+        }
+        catch (...) {
+        }
+    }
+
+    int32_t SpellChecker::wordFreq(const String& word) const
+    {
+        // the index itself is up to date, the spellchecker index may lag behind it
+        int32_t freq = 0;
+        for (const auto& fieldName : m_fields) {
+            freq += m_indexReader->docFreq(newLucene<Term>(fieldName, word));
+        }
+        return freq;
+    }
+
+    std::vector<SpellSuggestion> SpellChecker::suggestSimilar(const String& word, size_t n) const
+    {
+        std::vector<SpellSuggestion> suggestions;
+        const auto length = word.length();
+        if (length < MIN_WORD_LENGTH || n == 0) {
+            return suggestions;
+        }
+
+        // candidates share n-grams with the word, a common beginning weighs more
+        auto query = newLucene<BooleanQuery>();
+        for (int32_t ng = getMinGram(length); ng <= getMaxGram(length); ++ng) {
+            if (length < static_cast<size_t>(ng)) {
+                break;
+            }
+            auto startQuery = newLucene<TermQuery>(newLucene<Term>(gramField(L"start", ng), word.substr(0, ng)));
+            startQuery->setBoost(2.0);
+            query->add(startQuery, BooleanClause::SHOULD);
+            query->add(newLucene<TermQuery>(newLucene<Term>(gramField(L"end", ng), word.substr(length - ng))), BooleanClause::SHOULD);
+            const auto gramName = gramField(L"gram", ng);
+            for (size_t i = 0; i + ng <= length; ++i) {
+                query->add(newLucene<TermQuery>(newLucene<Term>(gramName, word.substr(i, ng))), BooleanClause::SHOULD);
+            }
+        }
+
+        auto topDocs = m_searcher->search(query, static_cast<int32_t>(std::min<size_t>(n * 10, 1000)));
+        for (const auto& scoreDoc : topDocs->scoreDocs) {
+            auto doc = m_searcher->doc(scoreDoc->doc);
+            const auto candidate = doc->get(F_WORD);
+            if (candidate == word) {
+                continue;
+            }
+            const auto distance = levenshteinDistance(word, candidate);
+            const double similarity = 1.0 - static_cast<double>(distance) / std::max(length, candidate.length());
+            if (similarity < MIN_SIMILARITY) {
+                continue;
+            }
+            // words of deleted documents stay in the spellchecker index until it is rebuilt
+            const auto freq = wordFreq(candidate);
+            if (freq == 0) {
+                continue;
+            }
+            suggestions.push_back({ candidate, freq, similarity });
+        }
+
+        std::sort(suggestions.begin(), suggestions.end(), [](const SpellSuggestion& a, const SpellSuggestion& b) {
+            return a.similarity > b.similarity || (a.similarity == b.similarity && a.docFreq > b.docFreq);
+        });
+        if (suggestions.size() > n) {
+            suggestions.resize(n);
+        }
+        return suggestions;
+    }
+}
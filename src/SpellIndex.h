@@ -0,0 +1,123 @@
+#ifndef SPELL_INDEX_H
+#define SPELL_INDEX_H
+
+/**
+ *  Side index of the words of a full-text index for spelling correction.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "LuceneHeaders.h"
+#include "FTSIndex.h"
+#include "FTSUtils.h"
+
+namespace LuceneUDR
+{
+    /// <summary>
+    /// Correction of a misspelled word.
+    /// </summary>
+    struct SpellSuggestion
+    {
+        Lucene::String word;
+        // number of documents of the full-text index containing the word, summed over the fields
+        int32_t docFreq;
+        // 1 - edit distance / length of the longer word
+        double similarity;
+    };
+
+    /// <summary>
+    /// Returns the path of the spellchecker index of a full-text index. 
+    /// It is located next to the index directory and named after it with the suffix ".spell".
+    /// </summary>
+    inline fs::path getSpellDirectoryPath(const fs::path& indexDirectoryPath)
+    {
+        fs::path spellDirectoryPath(indexDirectoryPath);
+        spellDirectoryPath += ".spell";
+        return spellDirectoryPath;
+    }
+
+    /// <summary>
+    /// Returns whether the spellchecker index is kept for the full-text index (option spellIndex of fts.ini).
+    /// </summary>
+    bool isSpellIndexEnabled(Firebird::ThrowStatusWrapper* status, const FtsConfig& config, std::string_view indexName);
+
+    /// <summary>
+    /// Returns the names of the index fields whose terms are put into the spellchecker index.
+    /// </summary>
+    Lucene::Collection<Lucene::String> getSpellFields(const FTSMetadata::FTSIndex& ftsIndex);
+
+    /// <summary>
+    /// Builds the spellchecker index from the terms of the full-text index. 
+    /// Each word becomes a document with its character n-grams, as in the Lucene SpellChecker contrib. 
+    /// An existing spellchecker index is replaced.
+    /// </summary>
+    /// 
+    /// <param name="indexDirectoryPath">Path to the full-text index directory</param>
+    /// <param name="shardPaths">Directories of the index shards</param>
+    /// <param name="fields">Fields whose terms are taken</param>
+    void buildSpellIndex(
+        const fs::path& indexDirectoryPath, 
+        const std::vector<fs::path>& shardPaths, 
+        const Lucene::Collection<Lucene::String>& fields);
+
+    /// <summary>
+    /// Adds the terms of the full-text index that are missing from the spellchecker index. 
+    /// Does nothing if the spellchecker index does not exist or the full-text index has not changed since it was last updated. 
+    /// Words of deleted documents are only removed by building the spellchecker index again.
+    /// </summary>
+    /// 
+    /// <param name="indexDirectoryPath">Path to the full-text index directory</param>
+    /// <param name="shardPaths">Directories of the index shards</param>
+    /// <param name="fields">Fields whose terms are taken</param>
+    void updateSpellIndex(
+        const fs::path& indexDirectoryPath, 
+        const std::vector<fs::path>& shardPaths, 
+        const Lucene::Collection<Lucene::String>& fields);
+
+    /// <summary>
+    /// Searches the spellchecker index for words similar to a given one. 
+    /// Document frequencies are taken from the full-text index, so words added after the spellchecker index 
+    /// was last updated are known and words of deleted documents are not suggested.
+    /// </summary>
+    class SpellChecker final
+    {
+    public:
+        SpellChecker(
+            const fs::path& spellDirectoryPath, 
+            const Lucene::IndexReaderPtr& indexReader, 
+            const Lucene::Collection<Lucene::String>& fields);
+        ~SpellChecker();
+
+        SpellChecker(const SpellChecker&) = delete;
+        SpellChecker& operator=(const SpellChecker&) = delete;
+
+        /// <summary>
+        /// Returns the number of documents containing the word, 0 if the word is unknown.
+        /// </summary>
+        int32_t wordFreq(const Lucene::String& word) const;
+
+        /// <summary>
+        /// Returns up to n known words similar to the given one, the most similar first.
+        /// </summary>
+        std::vector<SpellSuggestion> suggestSimilar(const Lucene::String& word, size_t n) const;
+
+    private:
+        Lucene::IndexReaderPtr m_reader;
+        Lucene::IndexSearcherPtr m_searcher;
+        Lucene::IndexReaderPtr m_indexReader;
+        Lucene::Collection<Lucene::String> m_fields;
+    };
+}
+
+#endif // SPELL_INDEX_H
@@ -0,0 +1,191 @@
+/**
+ *  Prefix completion of index terms for search-as-you-type.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "TermSuggester.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+#include "IndexDirectory.h"
+
+using namespace Lucene;
+
+namespace
+{
+    struct CachedSuggester
+    {
+        int64_t version;
+        LuceneUDR::TermSuggesterPtr suggester;
+    };
+
+    std::mutex suggesterCacheMutex;
+    std::map<std::string, CachedSuggester> suggesterCache;
+}
+
+namespace LuceneUDR
+{
+
+    TermSuggester::TermSuggester(const IndexReaderPtr& reader, const String& fieldName)
+    {
+        std::vector<std::string> terms;
+        std::vector<int32_t> weights;
+        auto termEnum = reader->terms(newLucene<Term>(fieldName));
+        do {
+            auto term = termEnum->term();
+            if (!term || term->field() != fieldName) {
+                break;
+            }
+            terms.push_back(StringUtils::toUTF8(term->text()));
+            weights.push_back(termEnum->docFreq());
+        } while (termEnum->next());
+        termEnum->close();
+
+        // Lucene orders terms by UTF-16 code units, prefix ranges need UTF-8 byte order
+        std::vector<uint32_t> order(terms.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&terms](uint32_t a, uint32_t b) {
+            return terms[a] < terms[b];
+        });
+
+        const size_t textSize = std::accumulate(terms.cbegin(), terms.cend(), size_t(0), 
+            [](size_t size, const std::string& s) { return size + s.size(); });
+        if (textSize > std::numeric_limits<uint32_t>::max()) {
+            boost::throw_exception(RuntimeException(L"Term dictionary of field " + fieldName + L" is too large"));
+        }
+        m_text.reserve(textSize);
+        m_offsets.reserve(terms.size() + 1);
+        m_weights.reserve(terms.size());
+        for (const auto i : order) {
+            m_offsets.push_back(static_cast<uint32_t>(m_text.size()));
+            m_text += terms[i];
+            m_weights.push_back(weights[i]);
+        }
+        m_offsets.push_back(static_cast<uint32_t>(m_text.size()));
+
+        m_leaves = 1;
+        while (m_leaves < m_weights.size()) {
+            m_leaves <<= 1;
+        }
+        m_tree.assign(2 * m_leaves, 0);
+        for (size_t i = 0; i < m_weights.size(); ++i) {
+            m_tree[m_leaves + i] = static_cast<uint32_t>(i);
+        }
+        for (size_t node = m_leaves - 1; node > 0; --node) {
+            const auto left = m_tree[2 * node];
+            const auto right = m_tree[2 * node + 1];
+            // padding leaves point to index 0 and never win over a real term on the right
+            m_tree[node] = (right < m_weights.size() && m_weights[right] > m_weights[left]) ? right : left;
+        }
+    }
+
+    size_t TermSuggester::maxWeightIndex(size_t first, size_t last) const
+    {
+        size_t best = first;
+        for (size_t l = first + m_leaves, r = last + m_leaves; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                const auto candidate = m_tree[l++];
+                if (m_weights[candidate] > m_weights[best] || (m_weights[candidate] == m_weights[best] && candidate < best)) {
+                    best = candidate;
+                }
+            }
+            if (r & 1) {
+                const auto candidate = m_tree[--r];
+                if (m_weights[candidate] > m_weights[best] || (m_weights[candidate] == m_weights[best] && candidate < best)) {
+                    best = candidate;
+                }
+            }
+        }
+        return best;
+    }
+
+    std::vector<TermSuggestion> TermSuggester::suggest(std::string_view prefix, size_t limit) const
+    {
+        std::vector<TermSuggestion> suggestions;
+        const size_t count = m_weights.size();
+
+        // range of the terms starting with the prefix
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (term(mid) < prefix) lo = mid + 1; else hi = mid;
+        }
+        const size_t first = lo;
+        hi = count;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (term(mid).substr(0, prefix.size()) == prefix) lo = mid + 1; else hi = mid;
+        }
+        const size_t last = lo;
+        if (first == last || limit == 0) {
+            return suggestions;
+        }
+
+        // each queue entry is a subrange together with its most frequent term
+        using Range = std::tuple<int32_t, size_t, size_t, size_t>;
+        auto cmp = [](const Range& a, const Range& b) {
+            return std::get<0>(a) < std::get<0>(b) || (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) > std::get<1>(b));
+        };
+        std::priority_queue<Range, std::vector<Range>, decltype(cmp)> ranges(cmp);
+        auto pushRange = [this, &ranges](size_t from, size_t to) {
+            if (from < to) {
+                const auto best = maxWeightIndex(from, to);
+                ranges.emplace(m_weights[best], best, from, to);
+            }
+        };
+
+        pushRange(first, last);
+        suggestions.reserve(std::min(limit, last - first));
+        while (!ranges.empty() && suggestions.size() < limit) {
+            const auto [weight, best, from, to] = ranges.top();
+            ranges.pop();
+            suggestions.push_back({ std::string(term(best)), weight });
+            pushRange(from, best);
+            pushRange(best + 1, to);
+        }
+        return suggestions;
+    }
+
+    TermSuggesterPtr getTermSuggester(const std::string& indexDirectoryPath, const Collection<DirectoryPtr>& directories, const String& fieldName)
+    {
+        // reading segments.gen is cheap compared to enumerating the term dictionary, 
+        // versions only grow, so their sum changes whenever any shard changes
+        int64_t version = 0;
+        for (const auto& directory : directories) {
+            version += IndexReader::getCurrentVersion(directory);
+        }
+        std::string key(indexDirectoryPath);
+        key += '\n';
+        key += StringUtils::toUTF8(fieldName);
+        {
+            std::lock_guard<std::mutex> lock(suggesterCacheMutex);
+            auto it = suggesterCache.find(key);
+            if (it != suggesterCache.end() && it->second.version == version) {
+                return it->second.suggester;
+            }
+        }
+
+        // built without holding the lock, so other indexes are not blocked meanwhile
+        auto reader = openIndexReader(directories);
+        auto suggester = std::make_shared<const TermSuggester>(reader, fieldName);
+        reader->close();
+
+        std::lock_guard<std::mutex> lock(suggesterCacheMutex);
+        suggesterCache.insert_or_assign(std::move(key), CachedSuggester{ version, suggester });
+        return suggester;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef TERM_SUGGESTER_H
+#define TERM_SUGGESTER_H
+
+/**
+ *  Prefix completion of index terms for search-as-you-type.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+    /// <summary>
+    /// Completion of a prefix.
+    /// </summary>
+    struct TermSuggestion
+    {
+        std::string term;
+        int32_t docFreq;
+    };
+
+    /// <summary>
+    /// Read-only dictionary of the terms of one field weighted by their document frequency.
+    /// 
+    /// Terms are stored as one UTF-8 buffer sorted in byte order, so the completions of a prefix 
+    /// form a contiguous range found by binary search. A max-tree over the document frequencies 
+    /// gives the most frequent terms of the range in O(n log N) without scanning it.
+    /// </summary>
+    class TermSuggester final
+    {
+    public:
+        TermSuggester(const Lucene::IndexReaderPtr& reader, const Lucene::String& fieldName);
+
+        TermSuggester(const TermSuggester&) = delete;
+        TermSuggester& operator=(const TermSuggester&) = delete;
+
+        /// <summary>
+        /// Returns up to limit terms starting with prefix, the most frequent first.
+        /// </summary>
+        std::vector<TermSuggestion> suggest(std::string_view prefix, size_t limit) const;
+
+        size_t size() const
+        {
+            return m_weights.size();
+        }
+
+    private:
+        std::string_view term(size_t i) const
+        {
+            return std::string_view(m_text.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+        }
+
+        size_t maxWeightIndex(size_t first, size_t last) const;
+
+        std::string m_text;
+        std::vector<uint32_t> m_offsets;
+        std::vector<int32_t> m_weights;
+        // m_tree[m_leaves + i] == i, inner nodes hold the index of the most frequent term below them
+        std::vector<uint32_t> m_tree;
+        size_t m_leaves = 0;
+    };
+
+    using TermSuggesterPtr = std::shared_ptr<const TermSuggester>;
+
+    /// <summary>
+    /// Returns the term dictionary of a field of the index. 
+    /// Dictionaries are built on first use and cached until the index changes.
+    /// </summary>
+    /// 
+    /// <param name="indexDirectoryPath">Path to the index directory, the cache key</param>
+    /// <param name="directories">Directories of the index shards</param>
+    /// <param name="fieldName">Field name</param>
+    /// 
+    /// <returns>Term dictionary</returns>
+    TermSuggesterPtr getTermSuggester(
+        const std::string& indexDirectoryPath, 
+        const Lucene::Collection<Lucene::DirectoryPtr>& directories, 
+        const Lucene::String& fieldName);
+}
+
+#endif // TERM_SUGGESTER_H